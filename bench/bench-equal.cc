@@ -0,0 +1,77 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+/*
+ * Object comparison cost per member for objects of growing
+ * size. Cost must stay flat, or grow with log n at most, for
+ * members in the same and in a different order.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include <jsoncc.h>
+
+#include "bench.h"
+
+namespace {
+
+/* n members with small object values in the given key order */
+Json::Object object(std::vector<size_t> const& keys)
+{
+	Json::Object res;
+	res.reserve(keys.size());
+	for (auto key: keys) {
+		res << Json::Member("key-" + std::to_string(key), Json::Object{
+			{"id", Json::Number(uint64_t(key))},
+			{"name", Json::String("element")},
+		});
+	}
+	return res;
+}
+
+/* nanoseconds per member, best of a few runs */
+double measure(Json::Object const& l, Json::Object const& r)
+{
+	double best(0.0);
+	for (int run(0); run < 5; ++run) {
+		auto start(std::chrono::steady_clock::now());
+		if (!Json::equal(l, r)) {
+			fprintf(stderr, "objects differ\n");
+		}
+		std::chrono::duration<double, std::nano> elapsed(
+			std::chrono::steady_clock::now() - start);
+		auto per_member(elapsed.count() / l.size());
+		if (run == 0 || per_member < best) {
+			best = per_member;
+		}
+	}
+	return best;
+}
+
+}
+
+void bench_equal()
+{
+	printf("%-6s %10s %12s %12s %12s\n", "equal", "size", "same order", "reversed", "shuffled");
+	for (size_t n(1 << 6); n <= (1 << 14); n *= 4) {
+		std::vector<size_t> keys(n);
+		for (size_t i(0); i < n; ++i) {
+			keys[i] = i;
+		}
+		auto forward(object(keys));
+		auto copy(object(keys));
+
+		std::reverse(keys.begin(), keys.end());
+		auto reversed(object(keys));
+
+		std::shuffle(keys.begin(), keys.end(), std::mt19937(n));
+		auto shuffled(object(keys));
+
+		printf("%-6s %10zu %9.2f ns %9.2f ns %9.2f ns\n", "", n,
+			measure(forward, copy), measure(forward, reversed), measure(forward, shuffled));
+	}
+}
@@ -0,0 +1,101 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+/*
+ * Serialization cost per output byte for documents of growing
+ * size. Cost must stay flat as documents grow wider or deeper.
+ */
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <sstream>
+
+#include <jsoncc.h>
+
+#include "bench.h"
+
+namespace {
+
+/* n objects with a few members each */
+Json::Value wide(size_t n)
+{
+	Json::Array res;
+	for (size_t i(0); i < n; ++i) {
+		res << Json::Object{
+			{"id", Json::Number(uint64_t(i))},
+			{"name", Json::String("element")},
+			{"value", Json::Number(i * 0.5)},
+			{"tags", Json::Array{Json::True(), Json::Null()}},
+		};
+	}
+	return Json::Value(std::move(res));
+}
+
+/* n levels of nested objects and arrays */
+Json::Value deep(size_t n)
+{
+	Json::Value res(Json::Number(0));
+	for (size_t i(0); i < n; ++i) {
+		if (i % 2) {
+			res = Json::Array{res, Json::Number(uint64_t(i))};
+		} else {
+			res = Json::Object{{"k", res}};
+		}
+	}
+	return res;
+}
+
+/* nanoseconds per output byte, best of a few runs */
+double measure(std::function<size_t()> serialize)
+{
+	double best(0.0);
+	for (int run(0); run < 5; ++run) {
+		auto start(std::chrono::steady_clock::now());
+		auto bytes(serialize());
+		std::chrono::duration<double, std::nano> elapsed(
+			std::chrono::steady_clock::now() - start);
+		auto per_byte(elapsed.count() / bytes);
+		if (run == 0 || per_byte < best) {
+			best = per_byte;
+		}
+	}
+	return best;
+}
+
+void bench(char const* name, std::function<Json::Value(size_t)> make, size_t max)
+{
+	printf("%-6s %10s %12s %12s %12s\n", name, "size", "ostream", "writer", "indented");
+	for (size_t n(max / 64); n <= max; n *= 2) {
+		auto doc(make(n));
+
+		auto ostream(measure([&doc]() {
+			std::ostringstream ss;
+			ss << Json::noindent << doc;
+			return ss.str().size();
+		}));
+
+		auto writer(measure([&doc]() {
+			Json::Writer writer(Json::Writer::STYLE_NOINDENT);
+			writer.value(doc);
+			return writer.size();
+		}));
+
+		auto indented(measure([&doc]() {
+			Json::Writer writer(Json::Writer::STYLE_INDENT);
+			writer.value(doc);
+			return writer.size();
+		}));
+
+		printf("%-6s %10zu %9.2f ns %9.2f ns %9.2f ns\n", "", n, ostream, writer, indented);
+	}
+}
+
+}
+
+void bench_serialize()
+{
+	bench("wide", wide, 1 << 16);
+	bench("deep", deep, 1 << 12);
+}
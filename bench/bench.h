@@ -0,0 +1,12 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#ifndef JSONCC_BENCH_H
+#define JSONCC_BENCH_H
+
+void bench_serialize();
+void bench_equal();
+
+#endif
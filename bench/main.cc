@@ -0,0 +1,13 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include "bench.h"
+
+int main()
+{
+	bench_serialize();
+	bench_equal();
+	return 0;
+}
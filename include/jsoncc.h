@@ -28,11 +28,15 @@
 
 #include <stdint.h>
 
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace Json {
@@ -52,7 +56,7 @@ public:
 
 	Number();
 	Number(Number const&);
-	Number(Number &&);
+	Number(Number &&) noexcept;
 	Number(uint8_t);
 	Number(int8_t);
 	Number(uint16_t);
@@ -66,7 +70,7 @@ public:
 	Number(long double);
 
 	Number & operator=(Number const&);
-	Number & operator=(Number &&);
+	Number & operator=(Number &&) noexcept;
 
 	Type type() const;
 	uint64_t uint_value() const;
@@ -87,17 +91,31 @@ class String {
 public:
 	String();
 	String(String const&);
-	String(String &&);
+	String(String &&) noexcept;
 	String(std::string const&);
+	String(std::string &&);
 	String(const char *);
 
+	/*
+	 * A String referencing size bytes at data without copying.
+	 * The buffer must outlive the String and all copies of it.
+	 */
+	static String reference(const char *, size_t);
+
 	String & operator=(String const&);
-	String & operator=(String &&);
+	String & operator=(String &&) noexcept;
 
 	std::string value() const;
 
+	bool is_reference() const;
+	/* not zero terminated for references */
+	const char *data() const;
+	size_t size() const;
+
 private:
 	std::string value_;
+	const char *ref_;
+	size_t ref_size_;
 };
 
 template<typename T> struct ValueFactory;
@@ -141,11 +159,13 @@ public:
 	Value(String const&);
 	Value(Object const&);
 	Value(Array const&);
+	Value(Object &&);
+	Value(Array &&);
 
 	Value(Value const&);
-	Value(Value&&);
+	Value(Value&&) noexcept;
 	Value & operator=(Value const&);
-	Value & operator=(Value&&);
+	Value & operator=(Value&&) noexcept;
 	~Value();
 
 	void set(Null const&);
@@ -166,6 +186,9 @@ public:
 	Object const& object() const;
 	Array const& array() const;
 
+	Object & object();
+	Array & array();
+
 private:
 	void clone(Value const&);
 	void clear();
@@ -187,14 +210,17 @@ class Member {
 public:
 	Member();
 	Member(Member const&);
-	Member(Member &&);
-	Member(std::string const&, Value const&);
+	Member(Member &&) noexcept;
+	Member(String const&, Value const&);
+	Member(String const&, Value &&);
+	Member(String &&, Value &&);
 
 	Member & operator=(Member const&);
-	Member & operator=(Member &&);
+	Member & operator=(Member &&) noexcept;
 
-	String key() const;
-	Value value() const;
+	String const& key() const;
+	Value const& value() const;
+	Value & value();
 
 private:
 	String key_;
@@ -206,50 +232,115 @@ public:
 	Object();
 	explicit Object(std::initializer_list<Member> l);
 	Object(Object const&);
-	Object(Object &&);
+	Object(Object &&) noexcept;
 
 	Object & operator=(Object const&);
-	Object & operator=(Object &&);
+	Object & operator=(Object &&) noexcept;
 	Object & operator<<(Member const&);
 	Object & operator<<(Member &&);
 
+	/* preallocate space for members */
+	void reserve(size_t);
+	size_t capacity() const;
+	void shrink_to_fit();
+
 	size_t size() const;
 	std::vector<Member> members() const;
 	Value member(std::string const&) const;
 
+	/* value of the first member with the key, nullptr if there is none */
+	Value const* find(std::string const&) const;
+	Value * find(std::string const&);
+	/* remove the first member with the key, false if there is none */
+	bool erase(std::string const&);
+
 	std::vector<Member>::const_iterator begin() const;
 	std::vector<Member>::const_iterator end() const;
+	std::vector<Member>::iterator begin();
+	std::vector<Member>::iterator end();
 
 private:
 	std::vector<Member> members_;
 };
 
+class CompactArray;
+
 class Array {
 public:
+	enum Storage {
+		STORAGE_VALUES,
+		STORAGE_INT,
+		STORAGE_UINT,
+		STORAGE_FP,
+	};
+
 	Array();
 	explicit Array(std::initializer_list<Value>);
 	Array(Array const&);
-	Array(Array &&);
+	Array(Array &&) noexcept;
 
 	template <typename InputIterator>
 	Array(InputIterator first, InputIterator last)
 	:
-		elements_(first, last)
+		elements_(first, last),
+		compact_()
 	{ }
 
+	/*
+	 * Arrays of numbers stored contiguously instead of one Value
+	 * per element, their elements are Numbers of TYPE_INT,
+	 * TYPE_UINT or TYPE_FP. Copies share the numbers.
+	 *
+	 * begin(), end() and elements() convert the numbers to Values
+	 * once, on first use. Appending converts the array to
+	 * STORAGE_VALUES.
+	 */
+	static Array numbers(std::vector<int64_t>);
+	static Array numbers(std::vector<uint64_t>);
+	static Array numbers(std::vector<double>);
+
 	Array & operator=(Array const&);
-	Array & operator=(Array &&);
+	Array & operator=(Array &&) noexcept;
 	Array & operator<<(Value const&);
 	Array & operator<<(Value &&);
 
+	/*
+	 * Preallocate space for elements, a compact array is
+	 * converted to STORAGE_VALUES first. The capacity of a
+	 * compact array is its size.
+	 */
+	void reserve(size_t);
+	size_t capacity() const;
+	void shrink_to_fit();
+
 	size_t size() const;
 	std::vector<Value> elements() const;
 
+	/*
+	 * Element access by position, which must be less than size().
+	 * Mutable access converts a compact array to STORAGE_VALUES.
+	 */
+	Value const& operator[](size_t) const;
+	Value & operator[](size_t);
+	/* insert before position, which must not exceed size() */
+	void insert(size_t, Value);
+	void erase(size_t);
+
 	std::vector<Value>::const_iterator begin() const;
 	std::vector<Value>::const_iterator end() const;
 
+	Storage storage() const;
+	/* numbers of the matching storage */
+	std::vector<int64_t> const& int_values() const;
+	std::vector<uint64_t> const& uint_values() const;
+	std::vector<double> const& fp_values() const;
+
 private:
+	std::vector<Value> const& values() const;
+	void detach();
+
 	std::vector<Value> elements_;
+	std::shared_ptr<CompactArray const> compact_;
 };
 
 template<> struct ValueFactory<bool>        { static void build(bool        const&, Value &); };
@@ -265,36 +356,190 @@ template<> struct ValueFactory<float>       { static void build(float       cons
 template<> struct ValueFactory<double>      { static void build(double      const&, Value &); };
 template<> struct ValueFactory<long double> { static void build(long double const&, Value &); };
 
+/*
+ * Number type of Array::numbers() for containers of E, void
+ * for element types that need a Value each. Characters keep
+ * their ValueFactory and are written as strings.
+ */
+template<typename E> struct CompactElement {
+	typedef typename std::conditional<
+		!std::is_arithmetic<E>::value ||
+		std::is_same<E, bool>::value ||
+		std::is_same<E, char>::value ||
+		std::is_same<E, signed char>::value ||
+		std::is_same<E, wchar_t>::value ||
+		std::is_same<E, char16_t>::value ||
+		std::is_same<E, char32_t>::value ||
+		std::is_same<E, long double>::value, void,
+		typename std::conditional<std::is_floating_point<E>::value, double,
+		typename std::conditional<std::is_signed<E>::value, int64_t,
+		uint64_t>::type>::type>::type type;
+};
+
+template <typename N, typename C>
+void build_array(C const& c, Value & res, std::true_type)
+{
+	res = Value(Array(c.begin(), c.end()));
+}
+
+template <typename N, typename C>
+void build_array(C const& c, Value & res, std::false_type)
+{
+	res = Value(Array::numbers(std::vector<N>(c.begin(), c.end())));
+}
+
+template <typename C>
+void build_array(C const& c, Value & res)
+{
+	typedef typename CompactElement<typename C::value_type>::type N;
+	build_array<N>(c, res, std::is_void<N>());
+}
+
 template<typename E> struct ValueFactory<std::vector<E> > {
 	static void build(std::vector<E> const& v, Value & res)
 	{
-		Json::Array a(v.begin(), v.end());
-		res.set(a);
+		build_array(v, res);
 	}
 };
 
 template<typename E> struct ValueFactory<std::list<E> > {
 	static void build(std::list<E> const& v, Value & res)
 	{
-		Json::Array a(v.begin(), v.end());
-		res.set(a);
+		build_array(v, res);
 	}
 };
 
 template<typename E> struct ValueFactory<std::set<E> > {
 	static void build(std::set<E> const& v, Value & res)
 	{
-		Json::Array a(v.begin(), v.end());
-		res.set(a);
+		build_array(v, res);
 	}
 };
 
+template <typename M>
+void build_object(M const& m, Value & res)
+{
+	static_assert(std::is_convertible<typename M::key_type, std::string>::value,
+		"map keys must be convertible to std::string");
+
+	Object object;
+	object.reserve(m.size());
+	for (auto const& member: m) {
+		object << Member(String(std::string(member.first)), Value(member.second));
+	}
+	res = Value(std::move(object));
+}
+
+template<typename K, typename E> struct ValueFactory<std::map<K, E> > {
+	static void build(std::map<K, E> const& v, Value & res)
+	{
+		build_object(v, res);
+	}
+};
+
+template<typename K, typename E> struct ValueFactory<std::unordered_map<K, E> > {
+	static void build(std::unordered_map<K, E> const& v, Value & res)
+	{
+		build_object(v, res);
+	}
+};
+
+/*
+ * Opt-in formatter for types converted to a String by the
+ * generic ValueFactory below, in the style of std::to_chars:
+ *
+ *   template<> struct ToChars<Baz> {
+ *     static const bool enabled = true;
+ *     static char *format(char *first, char *last, Baz const&);
+ *   };
+ *
+ * format() returns the end of the output, or nullptr if it does
+ * not fit into [first, last), it is retried with a larger buffer
+ * then.
+ */
+template<typename T> struct ToChars {
+	static const bool enabled = false;
+};
+
+class FormatStreamImpl;
+
+/*
+ * std::ostream kept per thread and reused by the generic
+ * ValueFactory instead of constructing a std::stringstream for
+ * every value. Formatting flags, exceptions and the classic
+ * locale are reset on construction, iword() and pword() slots
+ * are kept. A nested FormatStream falls back to a
+ * std::stringstream.
+ */
+class FormatStream {
+public:
+	FormatStream();
+	~FormatStream();
+
+	std::ostream & stream();
+	String str() const;
+
+private:
+	FormatStream(FormatStream const&) = delete;
+	FormatStream & operator=(FormatStream const&) = delete;
+
+	FormatStreamImpl *impl_;
+	std::unique_ptr<std::stringstream> nested_;
+};
+
+template <typename T>
+void format_value(T const& v, Value & res, std::true_type)
+{
+	char buf[64];
+	auto end(ToChars<T>::format(buf, buf + sizeof(buf), v));
+	if (end) {
+		res.set(String(std::string(buf, end)));
+		return;
+	}
+
+	std::string str(2 * sizeof(buf), '\0');
+	while (!(end = ToChars<T>::format(&str[0], &str[0] + str.size(), v))) {
+		str.resize(2 * str.size());
+	}
+	str.resize(end - &str[0]);
+	res.set(String(str));
+}
+
+template <typename T>
+void format_value(T const& v, Value & res, std::false_type)
+{
+	FormatStream fs;
+	operator<<(fs.stream(), v);
+	res.set(fs.str());
+}
+
+/*
+ * Integers of a type none of the fixed width types above is,
+ * like long long where int64_t is long, are Numbers as in
+ * containers. Other types are formatted to a String.
+ */
 template<typename T> struct ValueFactory {
 	static void build(T const& v, Value & res)
 	{
-		std::stringstream ss;
-		operator<<(ss, v);
-		res.set(ss.str());
+		build(v, res, std::integral_constant<bool,
+			std::is_integral<T>::value &&
+			!std::is_same<T, char>::value &&
+			!std::is_same<T, wchar_t>::value &&
+			!std::is_same<T, char16_t>::value &&
+			!std::is_same<T, char32_t>::value>());
+	}
+
+private:
+	static void build(T const& v, Value & res, std::true_type)
+	{
+		typedef typename std::conditional<std::is_signed<T>::value,
+			int64_t, uint64_t>::type N;
+		ValueFactory<N>::build(v, res);
+	}
+
+	static void build(T const& v, Value & res, std::false_type)
+	{
+		format_value(v, res, std::integral_constant<bool, ToChars<T>::enabled>());
 	}
 };
 
@@ -363,6 +608,30 @@ bool equal(Json::Object const&, Json::Object const&);
 /* Values are compared after unboxing using the rules above */
 bool equal(Json::Value const&, Json::Value const&);
 
+/*
+ * Structural hashes consistent with equal() above: values
+ * which are equal hash the same. Numbers include their
+ * Number::Type, members are combined independent of their
+ * order and compact arrays hash like their elements.
+ */
+uint64_t hash(Json::Number const&);
+uint64_t hash(Json::String const&);
+uint64_t hash(Json::Array const&);
+uint64_t hash(Json::Object const&);
+uint64_t hash(Json::Value const&);
+
+/*
+ * Key equality for unordered containers, to be used together
+ * with std::hash<Json::Value>:
+ * std::unordered_set<Json::Value, std::hash<Json::Value>, Json::ValueEqual>
+ */
+struct ValueEqual {
+	bool operator()(Json::Value const& l, Json::Value const& r) const
+	{
+		return equal(l, r);
+	}
+};
+
 struct Location {
 	size_t offs;
 	size_t character;
@@ -402,6 +671,15 @@ public:
 		BAD_TOKEN_OBJECT_SEP,   /* bad or missing  value in object member */
 		BAD_TOKEN_OBJECT_VALUE, /* expected ',' or '}' after object member */
 		BAD_TOKEN_OBJECT_NEXT,  /* object contains bad member */
+		BAD_COLUMN_DOCUMENT,    /* document is not an array of objects */
+		BAD_COLUMN_VALUE,       /* value does not match column type */
+		BAD_WRITER_CALL,        /* writer call does not match document structure */
+		WRITE_FAILED,           /* writing to file descriptor failed */
+		BAD_CANONICAL_NUMBER,   /* number has no canonical form (nan, inf) */
+		BAD_READER_TYPE,        /* value does not match the type read */
+		BAD_PATCH,              /* malformed patch operation */
+		BAD_PATCH_PATH,         /* patch path does not exist */
+		PATCH_TEST_FAILED,      /* patch test operation failed */
 		INTERNAL_ERROR,         /* internal error */
 	} type;
 
@@ -410,6 +688,189 @@ public:
 	Error(Type = OK, Location = Location());
 };
 
+/*
+ * A column of values extracted from an array of objects,
+ * see Parser::parse_columns() below.
+ *
+ * Values are stored contiguously in the vector matching the
+ * column type, one entry per array element. Elements where
+ * the member is missing or null hold a default value and are
+ * flagged in the null bitmap.
+ *
+ * Integer numbers are accepted for TYPE_DOUBLE columns,
+ * any other mismatch is an error.
+ */
+class Column {
+public:
+	enum Type {
+		TYPE_INT64,
+		TYPE_DOUBLE,
+		TYPE_STRING,
+		TYPE_BOOL,
+	};
+
+	Column(std::string const&, Type);
+
+	std::string const& key() const;
+	Type type() const;
+
+	size_t size() const;
+	bool null(size_t) const;
+	std::vector<bool> const& nulls() const;
+
+	std::vector<int64_t> const& int64_values() const;
+	std::vector<double> const& double_values() const;
+	std::vector<std::string> const& string_values() const;
+	std::vector<bool> const& bool_values() const;
+
+private:
+	friend class ColumnBuilder;
+
+	std::string key_;
+	Type type_;
+	std::vector<bool> nulls_;
+	std::vector<int64_t> int64_values_;
+	std::vector<double> double_values_;
+	std::vector<std::string> string_values_;
+	std::vector<bool> bool_values_;
+};
+
+class ReaderImpl;
+
+/*
+ * Pull reader decoding a document straight from the token
+ * stream, see ValueReader and Parser::parse_into() below.
+ *
+ * Values are consumed in document order, each call reads
+ * the next value and throws BAD_READER_TYPE if it is not
+ * of the requested kind or out of range. Containers are
+ * walked element by element:
+ *
+ *   reader.begin_array();
+ *   while (reader.next_element()) { read one value }
+ *
+ *   reader.begin_object();
+ *   while (reader.next_member(key)) { read one value }
+ *
+ * As with Parser the toplevel value must be an array or an
+ * object, end() checks that nothing follows it. Integer
+ * numbers are accepted by real(), floats by no integer call.
+ */
+class Reader {
+public:
+	Reader(char const *, size_t);
+	~Reader();
+
+	// throw Json::Error
+	/* Tag of the next value, nothing is consumed */
+	Value::Tag peek();
+
+	void null();
+	bool boolean();
+	int64_t int64();
+	uint64_t uint64();
+	long double real();
+	std::string string();
+	/* reads any value into a tree */
+	Value value();
+	/* consumes the next value without decoding it */
+	void skip();
+
+	void begin_array();
+	bool next_element();
+	void begin_object();
+	bool next_member(std::string & key);
+
+	void end();
+
+private:
+	Reader(Reader const&) = delete;
+	Reader & operator=(Reader const&) = delete;
+
+	std::unique_ptr<ReaderImpl> impl_;
+};
+
+/*
+ * Decodes the next value of a Reader into a T, the inverse of
+ * ValueFactory. Specialize it for custom types:
+ *
+ *   template<> struct ValueReader<Point> {
+ *     static void read(Reader & reader, Point & p) { ... }
+ *   };
+ *
+ * Containers are cleared before reading, duplicate std::map
+ * keys keep the last value.
+ */
+template<typename T> struct ValueReader;
+
+template<> struct ValueReader<bool>        { static void read(Reader &, bool        &); };
+template<> struct ValueReader<uint8_t>     { static void read(Reader &, uint8_t     &); };
+template<> struct ValueReader<int8_t>      { static void read(Reader &, int8_t      &); };
+template<> struct ValueReader<uint16_t>    { static void read(Reader &, uint16_t    &); };
+template<> struct ValueReader<int16_t>     { static void read(Reader &, int16_t     &); };
+template<> struct ValueReader<uint32_t>    { static void read(Reader &, uint32_t    &); };
+template<> struct ValueReader<int32_t>     { static void read(Reader &, int32_t     &); };
+template<> struct ValueReader<uint64_t>    { static void read(Reader &, uint64_t    &); };
+template<> struct ValueReader<int64_t>     { static void read(Reader &, int64_t     &); };
+template<> struct ValueReader<float>       { static void read(Reader &, float       &); };
+template<> struct ValueReader<double>      { static void read(Reader &, double      &); };
+template<> struct ValueReader<long double> { static void read(Reader &, long double &); };
+template<> struct ValueReader<std::string> { static void read(Reader &, std::string &); };
+template<> struct ValueReader<Value>       { static void read(Reader &, Value       &); };
+
+template<typename E> struct ValueReader<std::vector<E> > {
+	static void read(Reader & reader, std::vector<E> & res)
+	{
+		res.clear();
+		reader.begin_array();
+		while (reader.next_element()) {
+			E element = E();
+			ValueReader<E>::read(reader, element);
+			res.push_back(std::move(element));
+		}
+	}
+};
+
+template<typename E> struct ValueReader<std::list<E> > {
+	static void read(Reader & reader, std::list<E> & res)
+	{
+		res.clear();
+		reader.begin_array();
+		while (reader.next_element()) {
+			E element = E();
+			ValueReader<E>::read(reader, element);
+			res.push_back(std::move(element));
+		}
+	}
+};
+
+template<typename E> struct ValueReader<std::set<E> > {
+	static void read(Reader & reader, std::set<E> & res)
+	{
+		res.clear();
+		reader.begin_array();
+		while (reader.next_element()) {
+			E element = E();
+			ValueReader<E>::read(reader, element);
+			res.insert(std::move(element));
+		}
+	}
+};
+
+template<typename E> struct ValueReader<std::map<std::string, E> > {
+	static void read(Reader & reader, std::map<std::string, E> & res)
+	{
+		res.clear();
+		reader.begin_object();
+		std::string key;
+		while (reader.next_member(key)) {
+			E element = E();
+			ValueReader<E>::read(reader, element);
+			res[key] = std::move(element);
+		}
+	}
+};
+
 class ParserImpl;
 
 class Parser {
@@ -422,6 +883,75 @@ public:
 
 	// does not throw
 	Value parse(char const *, size_t, Error &);
+
+	/*
+	 * Strings without escape sequences reference the source
+	 * buffer instead of copying it, see String::reference().
+	 * The buffer must outlive the returned Value and every
+	 * String copied from it.
+	 */
+	// throws Json::Error
+	Value parse_zerocopy(char const *, size_t);
+
+	// does not throw
+	Value parse_zerocopy(char const *, size_t, Error &);
+
+	/*
+	 * Like parse_zerocopy() but escape sequences are decoded
+	 * in place, overwriting the buffer. Every String then
+	 * references the buffer, which must outlive the result.
+	 * The buffer contents are undefined after an error.
+	 */
+	// throws Json::Error
+	Value parse_insitu(char *, size_t);
+
+	// does not throw
+	Value parse_insitu(char *, size_t, Error &);
+
+	/*
+	 * Decode an array of objects straight into columns
+	 * without building Json::Value nodes. Members without
+	 * a matching column are skipped. The columns are cleared
+	 * before decoding.
+	 */
+	// throws Json::Error
+	void parse_columns(char const *, size_t, std::vector<Column> &);
+
+	// does not throw
+	void parse_columns(char const *, size_t, std::vector<Column> &, Error &);
+
+	/*
+	 * Decode a document into a T with ValueReader<T> without
+	 * building Json::Value nodes.
+	 */
+	// throws Json::Error
+	template <typename T>
+	T parse_into(char const * data, size_t size)
+	{
+		T res = T();
+		parse_into(data, size, res);
+		return res;
+	}
+
+	// throws Json::Error
+	template <typename T>
+	void parse_into(char const * data, size_t size, T & res)
+	{
+		Reader reader(data, size);
+		ValueReader<T>::read(reader, res);
+		reader.end();
+	}
+
+	// does not throw
+	template <typename T>
+	void parse_into(char const * data, size_t size, T & res, Error & err)
+	{
+		try {
+			parse_into(data, size, res);
+		} catch (Error & e) {
+			err = e;
+		}
+	}
 private:
 	Parser(Parser const&) = delete;
 	Parser & operator=(Parser const&) = delete;
@@ -429,6 +959,741 @@ private:
 	std::unique_ptr<ParserImpl> impl_;
 };
 
+class LazyDocumentImpl;
+class LazyObject;
+class LazyArray;
+
+/*
+ * Handle to a value of a LazyDocument.
+ *
+ * Handles are cheap to copy, they refer to the document
+ * they were obtained from, which must outlive them.
+ * number(), string() and value() parse the value's source
+ * text on each call and may throw Json::Error for errors
+ * not caught by the structural scan.
+ */
+class LazyValue {
+public:
+	explicit operator bool() const
+	{
+		return tag() != Value::TAG_INVALID;
+	}
+
+	LazyValue();
+
+	Value::Tag tag() const;
+
+	Number number() const;
+	String string() const;
+	LazyObject object() const;
+	LazyArray array() const;
+
+	/* materialize the whole subtree */
+	Value value() const;
+
+private:
+	friend class LazyDocument;
+	friend class LazyMember;
+	friend class LazyObject;
+	friend class LazyArray;
+
+	LazyValue(LazyDocumentImpl const*, size_t);
+
+	LazyDocumentImpl const* doc_;
+	size_t node_;
+};
+
+class LazyMember {
+public:
+	String key() const;
+	LazyValue value() const;
+
+private:
+	friend class LazyObject;
+
+	explicit LazyMember(LazyValue const&);
+
+	LazyValue value_;
+};
+
+class LazyObject {
+public:
+	class const_iterator {
+	public:
+		LazyMember operator*() const;
+		const_iterator & operator++();
+		bool operator==(const_iterator const&) const;
+		bool operator!=(const_iterator const&) const;
+
+	private:
+		friend class LazyObject;
+
+		explicit const_iterator(LazyValue const&);
+
+		LazyValue value_;
+	};
+
+	size_t size() const;
+	/* linear search, returns an invalid LazyValue if not found */
+	LazyValue member(std::string const&) const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	friend class LazyValue;
+
+	explicit LazyObject(LazyValue const&);
+
+	LazyValue value_;
+};
+
+class LazyArray {
+public:
+	class const_iterator {
+	public:
+		LazyValue operator*() const;
+		const_iterator & operator++();
+		bool operator==(const_iterator const&) const;
+		bool operator!=(const_iterator const&) const;
+
+	private:
+		friend class LazyArray;
+
+		explicit const_iterator(LazyValue const&);
+
+		LazyValue value_;
+	};
+
+	size_t size() const;
+	/* linear in the index, prefer iterators for traversal */
+	LazyValue element(size_t) const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	friend class LazyValue;
+
+	explicit LazyArray(LazyValue const&);
+
+	LazyValue value_;
+};
+
+/*
+ * On demand parsed document.
+ *
+ * The constructor only runs a structural scan of the source,
+ * recording the span of every value. Values are parsed when
+ * accessed through the LazyValue API. The source buffer is
+ * not copied and must outlive the document.
+ *
+ * The structural scan checks nesting, separators and string
+ * quoting. Literals, numbers and string contents are validated
+ * when accessed.
+ */
+class LazyDocument {
+public:
+	// throws Json::Error
+	LazyDocument(char const *, size_t);
+	~LazyDocument();
+
+	LazyValue root() const;
+
+private:
+	LazyDocument(LazyDocument const&) = delete;
+	LazyDocument & operator=(LazyDocument const&) = delete;
+
+	std::unique_ptr<LazyDocumentImpl> impl_;
+};
+
+class Tape;
+class TapeObject;
+class TapeArray;
+
+/*
+ * Handle to a value stored in a Tape.
+ *
+ * Handles are cheap to copy and refer to the tape they
+ * were obtained from, which must outlive them.
+ */
+class TapeValue {
+public:
+	explicit operator bool() const
+	{
+		return tag() != Value::TAG_INVALID;
+	}
+
+	TapeValue();
+
+	Value::Tag tag() const;
+
+	Number number() const;
+	String string() const;
+	/* points into the tape's string buffer, not zero terminated */
+	char const* string_data() const;
+	size_t string_size() const;
+	TapeObject object() const;
+	TapeArray array() const;
+
+	/* convert the subtree into a mutable Json::Value */
+	Value value() const;
+
+private:
+	friend class Tape;
+	friend class TapeMember;
+	friend class TapeObject;
+	friend class TapeArray;
+
+	TapeValue(Tape const*, size_t);
+
+	uint64_t word(size_t) const;
+	size_t next() const;
+
+	Tape const* tape_;
+	size_t index_;
+};
+
+class TapeMember {
+public:
+	String key() const;
+	TapeValue value() const;
+
+private:
+	friend class TapeObject;
+
+	explicit TapeMember(TapeValue const&);
+
+	TapeValue key_;
+};
+
+class TapeObject {
+public:
+	class const_iterator {
+	public:
+		TapeMember operator*() const;
+		const_iterator & operator++();
+		bool operator==(const_iterator const&) const;
+		bool operator!=(const_iterator const&) const;
+
+	private:
+		friend class TapeObject;
+
+		explicit const_iterator(TapeValue const&);
+
+		TapeValue key_;
+	};
+
+	size_t size() const;
+	/* linear search, returns an invalid TapeValue if not found */
+	TapeValue member(std::string const&) const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	friend class TapeValue;
+
+	explicit TapeObject(TapeValue const&);
+
+	TapeValue value_;
+};
+
+class TapeArray {
+public:
+	class const_iterator {
+	public:
+		TapeValue operator*() const;
+		const_iterator & operator++();
+		bool operator==(const_iterator const&) const;
+		bool operator!=(const_iterator const&) const;
+
+	private:
+		friend class TapeArray;
+
+		explicit const_iterator(TapeValue const&);
+
+		TapeValue value_;
+	};
+
+	size_t size() const;
+	/* linear in the index, prefer iterators for traversal */
+	TapeValue element(size_t) const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	friend class TapeValue;
+
+	explicit TapeArray(TapeValue const&);
+
+	TapeValue value_;
+};
+
+/*
+ * Immutable flat document representation.
+ *
+ * The whole document lives in two buffers: a tape of 64 bit
+ * words holding a type tag in the upper 8 bits and a payload
+ * in the lower 56 bits, and a buffer with the contents of all
+ * strings and keys.
+ *
+ *  null, true, false  tag only
+ *  integer, float     tag, followed by a word with the raw value
+ *  string, key        tag, offset of the string in the buffer
+ *  array, object      tag, index of the word after the closing word
+ *  closing word       tag, number of elements or members
+ *
+ * Members are stored as a key word followed by the value.
+ * Floating point numbers are stored as double.
+ */
+class Tape {
+public:
+	Tape();
+	// throws Json::Error
+	Tape(char const *, size_t);
+
+	TapeValue root() const;
+
+private:
+	friend class TapeValue;
+	friend class TapeBuilder;
+
+	std::vector<uint64_t> words_;
+	std::string strings_;
+};
+
+/* Destination for Writer output */
+class Sink {
+public:
+	virtual ~Sink();
+
+	/* data is only valid during the call */
+	virtual void write(char const *, size_t) = 0;
+
+	/*
+	 * Like write() but data stays valid until the next flush(),
+	 * a sink may keep a reference instead of copying it. Returns
+	 * true if it did, the Writer then flushes before the data
+	 * changes. Writer passes long string runs this way.
+	 */
+	virtual bool write_reference(char const *, size_t);
+
+	/* release references and pass on buffered output */
+	virtual void flush();
+
+	/* size of the chunks a Writer passes to write() */
+	virtual size_t chunk_size() const;
+};
+
+class FdSinkImpl;
+
+/*
+ * Sink writing to a blocking file descriptor or socket.
+ *
+ * Output is collected in a ring of fixed size buffers, which
+ * are passed to writev() in one call once all of them are full.
+ * Writes of at least the whole ring are not copied. A Writer
+ * passes its output in chunks of buffer_size.
+ *
+ * References of min_reference bytes or more are kept as their
+ * own iovec instead of copying them, 0 disables this.
+ */
+class FdSink : public Sink {
+public:
+	explicit FdSink(int fd, size_t buffer_count = 4,
+		size_t buffer_size = 1 << 14, size_t min_reference = 0);
+	/* flushes, errors are ignored */
+	~FdSink();
+
+	// throw Json::Error
+	void write(char const *, size_t);
+	bool write_reference(char const *, size_t);
+	void flush();
+	size_t chunk_size() const;
+
+private:
+	FdSink(FdSink const&) = delete;
+	FdSink & operator=(FdSink const&) = delete;
+
+	std::unique_ptr<FdSinkImpl> impl_;
+};
+
+class WriterImpl;
+
+/*
+ * Serializes values into a contiguous buffer without going
+ * through std::ostream. The output is byte identical to the
+ * operator<< overloads above with indent and noindent.
+ *
+ * Documents can be passed as a Value or be streamed element
+ * by element with the begin_* / end_* and key() calls, which
+ * do not build a Value tree. Streamed calls must form valid
+ * documents, a member value is preceeded by its key():
+ *
+ *   writer.begin_object().key("a").value(1).end_object();
+ *
+ * Out of order calls throw BAD_WRITER_CALL and leave the
+ * output unchanged. Toplevel values are written back to back.
+ *
+ * STYLE_CANONICAL writes the JSON Canonicalization Scheme of
+ * RFC 8785: no whitespace, members sorted by key and numbers
+ * as doubles in ECMAScript notation. Streamed members must
+ * be passed in that order. Numbers that are not finite throw
+ * BAD_CANONICAL_NUMBER, the other styles write them as null.
+ *
+ * With a Sink the buffer is handed to it whenever it fills
+ * up, on flush() and on destruction. Long strings are passed
+ * as Sink::write_reference(), if the sink keeps the reference
+ * it is flushed before value() returns.
+ */
+class Writer {
+public:
+	enum Style {
+		STYLE_INDENT,
+		STYLE_NOINDENT,
+		STYLE_CANONICAL,
+	};
+
+	/* STYLE_INDENT indents by indent_width indent_chars per level */
+	explicit Writer(Style = STYLE_INDENT,
+		char indent_char = '\t', size_t indent_width = 1);
+	explicit Writer(Sink &, Style = STYLE_INDENT,
+		char indent_char = '\t', size_t indent_width = 1);
+	/* flushes, errors are ignored */
+	~Writer();
+
+	// throw Json::Error
+	Writer & value(Value const&);
+	/* scalars without building a Value */
+	Writer & null();
+	Writer & boolean(bool);
+	Writer & number(Number const&);
+	Writer & string(String const&);
+	Writer & begin_object();
+	Writer & key(String const&);
+	/* key() of a name without escapes as the literal "\"name\": " */
+	Writer & quoted_key(char const *, size_t);
+	Writer & end_object();
+	Writer & begin_array();
+	Writer & end_array();
+
+	/* open containers of streamed calls */
+	size_t depth() const;
+
+	/* pass buffered output on and flush the sink */
+	void flush();
+
+	/* output not yet passed to a Sink */
+	char const* data() const;
+	size_t size() const;
+	std::string str() const;
+	void clear();
+
+private:
+	Writer(Writer const&) = delete;
+	Writer & operator=(Writer const&) = delete;
+
+	std::unique_ptr<WriterImpl> impl_;
+};
+
+/*
+ * Exact size of the Writer output for a value in the given
+ * layout, computed in one traversal without writing it.
+ */
+// throws Json::Error
+size_t serialized_size(Value const&, Writer::Style = Writer::STYLE_INDENT,
+	char indent_char = '\t', size_t indent_width = 1);
+
+/*
+ * Writes a value into buf without bounds checks, buf must hold
+ * serialized_size() bytes for the same arguments. Returns the
+ * length, the output is not zero terminated.
+ */
+// throws Json::Error
+size_t serialize(Value const&, char *buf, Writer::Style = Writer::STYLE_INDENT,
+	char indent_char = '\t', size_t indent_width = 1);
+
+/*
+ * Writes a T to a Writer without building a Value tree, the
+ * streaming counterpart of ValueFactory. Types without a
+ * specialization are converted with ValueFactory.
+ */
+template<typename T> struct ValueWriter {
+	static void write(Writer & writer, T const& v)
+	{
+		writer.value(Value(v));
+	}
+};
+
+template<> struct ValueWriter<bool>        { static void write(Writer &, bool        const&); };
+template<> struct ValueWriter<uint8_t>     { static void write(Writer &, uint8_t     const&); };
+template<> struct ValueWriter<int8_t>      { static void write(Writer &, int8_t      const&); };
+template<> struct ValueWriter<uint16_t>    { static void write(Writer &, uint16_t    const&); };
+template<> struct ValueWriter<int16_t>     { static void write(Writer &, int16_t     const&); };
+template<> struct ValueWriter<uint32_t>    { static void write(Writer &, uint32_t    const&); };
+template<> struct ValueWriter<int32_t>     { static void write(Writer &, int32_t     const&); };
+template<> struct ValueWriter<uint64_t>    { static void write(Writer &, uint64_t    const&); };
+template<> struct ValueWriter<int64_t>     { static void write(Writer &, int64_t     const&); };
+template<> struct ValueWriter<float>       { static void write(Writer &, float       const&); };
+template<> struct ValueWriter<double>      { static void write(Writer &, double      const&); };
+template<> struct ValueWriter<long double> { static void write(Writer &, long double const&); };
+template<> struct ValueWriter<std::string> { static void write(Writer &, std::string const&); };
+template<> struct ValueWriter<Value>       { static void write(Writer &, Value       const&); };
+
+template <typename C>
+void write_array(Writer & writer, C const& c)
+{
+	writer.begin_array();
+	for (auto const& element: c) {
+		ValueWriter<typename C::value_type>::write(writer, element);
+	}
+	writer.end_array();
+}
+
+template<typename E> struct ValueWriter<std::vector<E> > {
+	static void write(Writer & writer, std::vector<E> const& v)
+	{
+		write_array(writer, v);
+	}
+};
+
+template<typename E> struct ValueWriter<std::list<E> > {
+	static void write(Writer & writer, std::list<E> const& v)
+	{
+		write_array(writer, v);
+	}
+};
+
+template<typename E> struct ValueWriter<std::set<E> > {
+	static void write(Writer & writer, std::set<E> const& v)
+	{
+		write_array(writer, v);
+	}
+};
+
+template<typename E> struct ValueWriter<std::map<std::string, E> > {
+	static void write(Writer & writer, std::map<std::string, E> const& v)
+	{
+		writer.begin_object();
+		for (auto const& member: v) {
+			writer.key(String::reference(member.first.data(), member.first.size()));
+			ValueWriter<E>::write(writer, member.second);
+		}
+		writer.end_object();
+	}
+};
+
+/*
+ * Field list of a struct, declared once inside namespace Json
+ * with JSONCC_FIELDS. It generates the ValueWriter, ValueReader
+ * and ValueFactory specializations for the struct:
+ *
+ *   struct Point { int x; int y; std::string label; };
+ *
+ *   namespace Json {
+ *   JSONCC_FIELDS(Point, JSONCC_FIELD(x) JSONCC_FIELD(y) JSONCC_FIELD(label))
+ *   }
+ *
+ * Fields are written in list order under their names, keys
+ * are written from string literals quoted at compile time,
+ * field names are identifiers and need no escapes. Reading matches
+ * members by name, unknown members are skipped and missing
+ * fields keep their value. With STYLE_CANONICAL the fields must
+ * be listed in canonical key order.
+ */
+template<typename T> struct FieldList;
+
+#define JSONCC_FIELD(name) \
+	visitor(#name, sizeof(#name) - 1, "\"" #name "\": ", object.name);
+
+#define JSONCC_FIELDS(Type, fields)                                        \
+template<> struct FieldList<Type> {                                        \
+	template <typename Visitor, typename Struct>                       \
+	static void visit(Visitor & visitor, Struct & object)              \
+	{                                                                  \
+		fields                                                     \
+	}                                                                  \
+};                                                                         \
+template<> struct ValueWriter<Type> {                                      \
+	static void write(Writer & writer, Type const& v)                  \
+	{                                                                  \
+		write_fields(writer, v);                                   \
+	}                                                                  \
+};                                                                         \
+template<> struct ValueReader<Type> {                                      \
+	static void read(Reader & reader, Type & v)                        \
+	{                                                                  \
+		read_fields(reader, v);                                    \
+	}                                                                  \
+};                                                                         \
+template<> struct ValueFactory<Type> {                                     \
+	static void build(Type const& v, Value & res)                      \
+	{                                                                  \
+		build_fields(v, res);                                      \
+	}                                                                  \
+};
+
+/* FieldList visitors, see JSONCC_FIELDS */
+class FieldWriter {
+public:
+	explicit FieldWriter(Writer & writer)
+	:
+		writer_(writer)
+	{ }
+
+	template <typename T>
+	void operator()(char const *, size_t size, char const *quoted, T const& field)
+	{
+		writer_.quoted_key(quoted, size + 4);
+		ValueWriter<T>::write(writer_, field);
+	}
+
+private:
+	Writer & writer_;
+};
+
+class FieldReader {
+public:
+	FieldReader(Reader & reader, std::string const& key)
+	:
+		found(false),
+		reader_(reader),
+		key_(key)
+	{ }
+
+	template <typename T>
+	void operator()(char const *name, size_t size, char const *, T & field)
+	{
+		if (!found && key_.size() == size && key_.compare(0, size, name) == 0) {
+			ValueReader<T>::read(reader_, field);
+			found = true;
+		}
+	}
+
+	bool found;
+
+private:
+	Reader & reader_;
+	std::string const& key_;
+};
+
+class FieldBuilder {
+public:
+	explicit FieldBuilder(Object & object)
+	:
+		object_(object)
+	{ }
+
+	template <typename T>
+	void operator()(char const *name, size_t size, char const *, T const& field)
+	{
+		object_ << Member(std::string(name, size), Value(field));
+	}
+
+private:
+	Object & object_;
+};
+
+template <typename T>
+void write_fields(Writer & writer, T const& v)
+{
+	FieldWriter visitor(writer);
+	writer.begin_object();
+	FieldList<T>::visit(visitor, v);
+	writer.end_object();
+}
+
+template <typename T>
+void read_fields(Reader & reader, T & v)
+{
+	std::string key;
+	reader.begin_object();
+	while (reader.next_member(key)) {
+		FieldReader visitor(reader, key);
+		FieldList<T>::visit(visitor, v);
+		if (!visitor.found) {
+			reader.skip();
+		}
+	}
+}
+
+template <typename T>
+void build_fields(T const& v, Value & res)
+{
+	Object object;
+	FieldBuilder visitor(object);
+	FieldList<T>::visit(visitor, v);
+	res = Value(std::move(object));
+}
+
+class XXH64;
+
+/* Sink hashing its input with the 64 bit XXH64 */
+class HashSink : public Sink {
+public:
+	explicit HashSink(uint64_t seed = 0);
+	~HashSink();
+
+	void write(char const *, size_t);
+	uint64_t digest() const;
+
+private:
+	HashSink(HashSink const&) = delete;
+	HashSink & operator=(HashSink const&) = delete;
+
+	std::unique_ptr<XXH64> impl_;
+};
+
+/*
+ * XXH64 of the canonical form of a value, see STYLE_CANONICAL.
+ * The hash is computed while serializing, the output is not
+ * materialized.
+ */
+// throws Json::Error
+uint64_t canonical_hash(Value const&, uint64_t seed = 0);
+
+/*
+ * JSON Patch (rfc6902) turning from into to, an array of
+ * operation objects. Unchanged subtrees yield no operations,
+ * array elements are matched by their hash() so inserted and
+ * removed elements do not touch the rest of the array.
+ * Objects with duplicate keys are replaced as a whole.
+ */
+Value diff(Value const& from, Value const& to);
+
+/*
+ * Apply a JSON Patch to doc in place. Operations are applied
+ * in order, after an error doc is left partially patched.
+ */
+// throws Json::Error
+void apply(Value & doc, Value const& patch);
+
+// does not throw
+void apply(Value & doc, Value const& patch, Error &);
+
+/*
+ * JSON Merge Patch (rfc7396) applied to target in place. Only
+ * members named in the patch are touched, null removes all
+ * members with that key. The rvalue overload moves the values
+ * of the patch into target instead of copying them.
+ */
+void merge_patch(Value & target, Value const& patch);
+void merge_patch(Value & target, Value && patch);
+
+}
+
+namespace std {
+
+template <>
+struct hash<Json::Value> {
+	size_t operator()(Json::Value const& value) const
+	{
+		return size_t(Json::hash(value));
+	}
+};
+
 }
 
 #endif
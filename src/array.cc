@@ -4,76 +4,269 @@
    license that can be found in the LICENSE file.
 */
 
+#include <atomic>
+#include <cassert>
+
 #include <jsoncc.h>
 
 namespace Json {
 
+/*
+ * Numbers of a compact Array. They are immutable once built,
+ * the Values for iteration are created by the first caller
+ * of values() and published atomically.
+ */
+class CompactArray {
+public:
+	explicit CompactArray(Array::Storage storage_)
+	:
+		storage(storage_),
+		ints(),
+		uints(),
+		fps(),
+		values_(nullptr)
+	{ }
+
+	~CompactArray()
+	{
+		delete values_.load();
+	}
+
+	size_t size() const
+	{
+		switch (storage) {
+		case Array::STORAGE_INT:    return ints.size();
+		case Array::STORAGE_UINT:   return uints.size();
+		case Array::STORAGE_FP:     return fps.size();
+		case Array::STORAGE_VALUES: assert(false); // LCOV_EXCL_LINE
+		}
+		return 0;                                  // LCOV_EXCL_LINE
+	}
+
+	std::vector<Value> const& values() const
+	{
+		auto res(values_.load(std::memory_order_acquire));
+		if (res) {
+			return *res;
+		}
+
+		std::unique_ptr<std::vector<Value> > values(new std::vector<Value>());
+		switch (storage) {
+		case Array::STORAGE_INT:    convert(ints, *values);  break;
+		case Array::STORAGE_UINT:   convert(uints, *values); break;
+		case Array::STORAGE_FP:     convert(fps, *values);   break;
+		case Array::STORAGE_VALUES: assert(false);           // LCOV_EXCL_LINE
+		}
+
+		if (values_.compare_exchange_strong(res, values.get(),
+		    std::memory_order_acq_rel, std::memory_order_acquire)) {
+			return *values.release();
+		}
+		return *res; // LCOV_EXCL_LINE lost the race
+	}
+
+	Array::Storage const storage;
+	std::vector<int64_t> ints;
+	std::vector<uint64_t> uints;
+	std::vector<double> fps;
+
+private:
+	CompactArray(CompactArray const&) = delete;
+	CompactArray & operator=(CompactArray const&) = delete;
+
+	template <typename T>
+	static void convert(std::vector<T> const& numbers, std::vector<Value> & res)
+	{
+		res.reserve(numbers.size());
+		for (auto number: numbers) {
+			res.push_back(Number(number));
+		}
+	}
+
+	mutable std::atomic<std::vector<Value> *> values_;
+};
+
 Array::Array()
 :
-	elements_()
+	elements_(),
+	compact_()
 { }
 
 Array::Array(std::initializer_list<Value> l)
 :
-	elements_(l)
+	elements_(l),
+	compact_()
 { }
 
 Array::Array(Array const& o)
 :
-	elements_(o.elements_)
+	elements_(o.elements_),
+	compact_(o.compact_)
 { }
 
-Array::Array(Array && o)
+Array::Array(Array && o) noexcept
 :
-	elements_(std::move(o.elements_))
+	elements_(std::move(o.elements_)),
+	compact_(std::move(o.compact_))
 { }
 
+Array Array::numbers(std::vector<int64_t> numbers)
+{
+	std::shared_ptr<CompactArray> compact(new CompactArray(STORAGE_INT));
+	compact->ints.swap(numbers);
+	Array res;
+	res.compact_ = std::move(compact);
+	return res;
+}
+
+Array Array::numbers(std::vector<uint64_t> numbers)
+{
+	std::shared_ptr<CompactArray> compact(new CompactArray(STORAGE_UINT));
+	compact->uints.swap(numbers);
+	Array res;
+	res.compact_ = std::move(compact);
+	return res;
+}
+
+Array Array::numbers(std::vector<double> numbers)
+{
+	std::shared_ptr<CompactArray> compact(new CompactArray(STORAGE_FP));
+	compact->fps.swap(numbers);
+	Array res;
+	res.compact_ = std::move(compact);
+	return res;
+}
+
 Array & Array::operator=(Array const& o)
 {
 	if (&o != this) {
 		elements_ = o.elements_;
+		compact_ = o.compact_;
 	}
 	return *this;
 }
 
-Array & Array::operator=(Array && o)
+Array & Array::operator=(Array && o) noexcept
 {
 	if (&o != this) {
 		elements_ = std::move(o.elements_);
+		compact_ = std::move(o.compact_);
 	}
 	return *this;
 }
 
 Array & Array::operator<<(Value const& element)
 {
+	detach();
 	elements_.push_back(element);
 	return *this;
 }
 
 Array & Array::operator<<(Value && element)
 {
+	detach();
 	elements_.push_back(std::move(element));
 	return *this;
 }
 
+void Array::reserve(size_t size)
+{
+	detach();
+	elements_.reserve(size);
+}
+
+size_t Array::capacity() const
+{
+	return compact_ ? compact_->size() : elements_.capacity();
+}
+
+void Array::shrink_to_fit()
+{
+	elements_.shrink_to_fit();
+}
+
 size_t Array::size() const
 {
-	return elements_.size();
+	return compact_ ? compact_->size() : elements_.size();
 }
 
 std::vector<Value> Array::elements() const
 {
-	return elements_;
+	return values();
 }
 
 std::vector<Value>::const_iterator Array::begin() const
 {
-	return elements_.begin();
+	return values().begin();
 }
 
 std::vector<Value>::const_iterator Array::end() const
 {
-	return elements_.end();
+	return values().end();
+}
+
+Array::Storage Array::storage() const
+{
+	return compact_ ? compact_->storage : STORAGE_VALUES;
+}
+
+std::vector<int64_t> const& Array::int_values() const
+{
+	assert(storage() == STORAGE_INT);
+	return compact_->ints;
+}
+
+std::vector<uint64_t> const& Array::uint_values() const
+{
+	assert(storage() == STORAGE_UINT);
+	return compact_->uints;
+}
+
+std::vector<double> const& Array::fp_values() const
+{
+	assert(storage() == STORAGE_FP);
+	return compact_->fps;
+}
+
+Value const& Array::operator[](size_t pos) const
+{
+	assert(pos < size());
+	return values()[pos];
+}
+
+Value & Array::operator[](size_t pos)
+{
+	assert(pos < size());
+	detach();
+	return elements_[pos];
+}
+
+void Array::insert(size_t pos, Value value)
+{
+	assert(pos <= size());
+	detach();
+	elements_.insert(elements_.begin() + pos, std::move(value));
+}
+
+void Array::erase(size_t pos)
+{
+	assert(pos < size());
+	detach();
+	elements_.erase(elements_.begin() + pos);
+}
+
+std::vector<Value> const& Array::values() const
+{
+	return compact_ ? compact_->values() : elements_;
+}
+
+/* switch to STORAGE_VALUES before modifying the elements */
+void Array::detach()
+{
+	if (compact_) {
+		elements_ = compact_->values();
+		compact_.reset();
+	}
 }
 
 }
@@ -0,0 +1,35 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#ifndef JSONCC_AUTO_LOCALE_H
+#define JSONCC_AUTO_LOCALE_H
+
+#include <locale.h>
+
+namespace Json {
+
+// POSIX thread local locale setting.
+class AutoLocale {
+public:
+	AutoLocale(const char *name)
+	:
+		locale_(newlocale(LC_ALL_MASK, name, 0)),
+		saved_(uselocale(locale_))
+	{ }
+
+	~AutoLocale()
+	{
+		uselocale(saved_);
+		freelocale(locale_);
+	}
+
+private:
+	locale_t locale_;
+	locale_t saved_;
+};
+
+}
+
+#endif
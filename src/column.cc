@@ -0,0 +1,227 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cassert>
+
+#include "parser-impl.h"
+
+#include "error.h"
+#include "token-stream.h"
+
+namespace Json {
+
+Column::Column(std::string const& key, Type type)
+:
+	key_(key),
+	type_(type),
+	nulls_(),
+	int64_values_(),
+	double_values_(),
+	string_values_(),
+	bool_values_()
+{ }
+
+std::string const& Column::key() const
+{
+	return key_;
+}
+
+Column::Type Column::type() const
+{
+	return type_;
+}
+
+size_t Column::size() const
+{
+	return nulls_.size();
+}
+
+bool Column::null(size_t row) const
+{
+	assert(row < nulls_.size());
+	return nulls_[row];
+}
+
+std::vector<bool> const& Column::nulls() const
+{
+	return nulls_;
+}
+
+std::vector<int64_t> const& Column::int64_values() const
+{
+	assert(type_ == TYPE_INT64);
+	return int64_values_;
+}
+
+std::vector<double> const& Column::double_values() const
+{
+	assert(type_ == TYPE_DOUBLE);
+	return double_values_;
+}
+
+std::vector<std::string> const& Column::string_values() const
+{
+	assert(type_ == TYPE_STRING);
+	return string_values_;
+}
+
+std::vector<bool> const& Column::bool_values() const
+{
+	assert(type_ == TYPE_BOOL);
+	return bool_values_;
+}
+
+/*
+ * Parser handler filling columns from an array of objects.
+ *
+ * depth_ 1 is the toplevel array, depth_ 2 the members
+ * of its objects. Anything nested deeper belongs to a
+ * skipped member.
+ */
+class ColumnBuilder : public ParserHandler {
+public:
+	explicit ColumnBuilder(std::vector<Column> & columns)
+	:
+		columns_(columns),
+		column_(nullptr),
+		depth_(0)
+	{
+		for (auto & column: columns_) {
+			column.nulls_.clear();
+			column.int64_values_.clear();
+			column.double_values_.clear();
+			column.string_values_.clear();
+			column.bool_values_.clear();
+		}
+	}
+
+	void value(Token const& token)
+	{
+		if (depth_ == 1) {
+			JSONCC_THROW(BAD_COLUMN_DOCUMENT);
+		}
+
+		if (depth_ == 2 && column_) {
+			store(*column_, token);
+		}
+	}
+
+	void begin_array()
+	{
+		begin_container(false);
+	}
+
+	void end_array()
+	{
+		--depth_;
+	}
+
+	void begin_object()
+	{
+		begin_container(true);
+		if (depth_ == 2) {
+			add_row();
+		}
+	}
+
+	void key(Token const& token)
+	{
+		if (depth_ == 2) {
+			column_ = find(token.str_value);
+		}
+	}
+
+	void end_object()
+	{
+		--depth_;
+	}
+
+private:
+	void begin_container(bool object)
+	{
+		if ((depth_ == 0 && object) || (depth_ == 1 && !object)) {
+			JSONCC_THROW(BAD_COLUMN_DOCUMENT);
+		}
+
+		if (depth_ == 2 && column_) {
+			JSONCC_THROW(BAD_COLUMN_VALUE);
+		}
+
+		++depth_;
+	}
+
+	Column *find(std::string const& key) const
+	{
+		for (auto & column: columns_) {
+			if (column.key_ == key) {
+				return &column;
+			}
+		}
+		return nullptr;
+	}
+
+	void add_row()
+	{
+		for (auto & column: columns_) {
+			column.nulls_.push_back(true);
+			switch (column.type_) {
+			case Column::TYPE_INT64:  column.int64_values_.push_back(0);    break;
+			case Column::TYPE_DOUBLE: column.double_values_.push_back(0.0); break;
+			case Column::TYPE_STRING: column.string_values_.emplace_back(); break;
+			case Column::TYPE_BOOL:   column.bool_values_.push_back(false); break;
+			}
+		}
+	}
+
+	void store(Column & column, Token const& token) const
+	{
+		if (token.type == Token::NULL_LITERAL) {
+			column.nulls_.back() = true;
+			return;
+		}
+
+		switch (column.type_) {
+		case Column::TYPE_INT64:
+			if (token.type != Token::NUMBER || token.number_type != Token::INT) {
+				JSONCC_THROW(BAD_COLUMN_VALUE);
+			}
+			column.int64_values_.back() = token.int_value;
+			break;
+		case Column::TYPE_DOUBLE:
+			if (token.type != Token::NUMBER) {
+				JSONCC_THROW(BAD_COLUMN_VALUE);
+			}
+			column.double_values_.back() = token.number_type == Token::FLOAT ?
+				double(token.float_value) : double(token.int_value);
+			break;
+		case Column::TYPE_STRING:
+			if (token.type != Token::STRING) {
+				JSONCC_THROW(BAD_COLUMN_VALUE);
+			}
+			column.string_values_.back() = token.str_value;
+			break;
+		case Column::TYPE_BOOL:
+			if (token.type != Token::TRUE_LITERAL && token.type != Token::FALSE_LITERAL) {
+				JSONCC_THROW(BAD_COLUMN_VALUE);
+			}
+			column.bool_values_.back() = token.type == Token::TRUE_LITERAL;
+			break;
+		}
+
+		column.nulls_.back() = false;
+	}
+
+	std::vector<Column> & columns_;
+	Column *column_;
+	size_t depth_;
+};
+
+void ParserImpl::parse(char const * data, size_t size, std::vector<Column> & columns)
+{
+	ColumnBuilder builder(columns);
+	parse(data, size, builder);
+}
+
+}
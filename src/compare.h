@@ -0,0 +1,21 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#ifndef JSONCC_COMPARE_H
+#define JSONCC_COMPARE_H
+
+#include <jsoncc.h>
+
+namespace Json {
+
+/* byte wise order of strings, as strcmp() */
+int compare(String const&, String const&);
+
+/* members ordered by key, duplicate keys in document order */
+std::vector<Member const*> sorted_members(Object const&);
+
+}
+
+#endif
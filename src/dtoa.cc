@@ -0,0 +1,500 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+/*
+ * Grisu3 as described in Florian Loitsch, "Printing Floating-Point
+ * Numbers Quickly and Accurately with Integers", PLDI 2010, with
+ * an exact fallback for the few values it rejects.
+ */
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "auto-locale.h"
+#include "dtoa.h"
+
+namespace {
+
+const uint64_t DP_SIGNIFICAND_MASK(0x000fffffffffffffULL);
+const uint64_t DP_EXPONENT_MASK(0x7ff0000000000000ULL);
+const uint64_t DP_HIDDEN_BIT(0x0010000000000000ULL);
+const int DP_SIGNIFICAND_SIZE(52);
+const int DP_EXPONENT_BIAS(0x3ff + DP_SIGNIFICAND_SIZE);
+const int DP_MIN_EXPONENT(-DP_EXPONENT_BIAS);
+
+/* floating point number f * 2^e with a 64 bit significand */
+struct DiyFp {
+	DiyFp(uint64_t f_, int e_)
+	:
+		f(f_),
+		e(e_)
+	{ }
+
+	explicit DiyFp(double d)
+	:
+		f(0),
+		e(0)
+	{
+		uint64_t bits;
+		memcpy(&bits, &d, sizeof(bits));
+		int biased_e((bits & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_SIZE);
+		f = bits & DP_SIGNIFICAND_MASK;
+		if (biased_e != 0) {
+			f += DP_HIDDEN_BIT;
+			e = biased_e - DP_EXPONENT_BIAS;
+		} else {
+			e = DP_MIN_EXPONENT + 1;
+		}
+	}
+
+	DiyFp operator-(DiyFp const& o) const
+	{
+		return DiyFp(f - o.f, e);
+	}
+
+	/* rounded upper 64 bits of the 128 bit product */
+	DiyFp operator*(DiyFp const& o) const
+	{
+		const uint64_t M32(0xffffffff);
+		uint64_t a(f >> 32), b(f & M32), c(o.f >> 32), d(o.f & M32);
+		uint64_t ac(a * c), bc(b * c), ad(a * d), bd(b * d);
+		uint64_t tmp((bd >> 32) + (ad & M32) + (bc & M32));
+		tmp += uint64_t(1) << 31;
+		return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + o.e + 64);
+	}
+
+	DiyFp normalize() const
+	{
+		DiyFp res(*this);
+		while (!(res.f & (uint64_t(1) << 63))) {
+			res.f <<= 1;
+			res.e--;
+		}
+		return res;
+	}
+
+	/* normalized m- and m+, the boundaries of the rounding interval */
+	void boundaries(DiyFp & minus, DiyFp & plus) const
+	{
+		plus = DiyFp((f << 1) + 1, e - 1).normalize();
+		minus = (f == DP_HIDDEN_BIT && e != DP_MIN_EXPONENT + 1) ?
+			DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
+		minus.f <<= minus.e - plus.e;
+		minus.e = plus.e;
+	}
+
+	uint64_t f;
+	int e;
+};
+
+/* normalized 10^k for k = -348, -340, ..., 340 */
+const struct {
+	uint64_t f;
+	int e;
+} CACHED_POWERS[] = {
+	{0xfa8fd5a0081c0288, -1220}, {0xbaaee17fa23ebf76, -1193}, {0x8b16fb203055ac76, -1166},
+	{0xcf42894a5dce35ea, -1140}, {0x9a6bb0aa55653b2d, -1113}, {0xe61acf033d1a45df, -1087},
+	{0xab70fe17c79ac6ca, -1060}, {0xff77b1fcbebcdc4f, -1034}, {0xbe5691ef416bd60c, -1007},
+	{0x8dd01fad907ffc3c,  -980}, {0xd3515c2831559a83,  -954}, {0x9d71ac8fada6c9b5,  -927},
+	{0xea9c227723ee8bcb,  -901}, {0xaecc49914078536d,  -874}, {0x823c12795db6ce57,  -847},
+	{0xc21094364dfb5637,  -821}, {0x9096ea6f3848984f,  -794}, {0xd77485cb25823ac7,  -768},
+	{0xa086cfcd97bf97f4,  -741}, {0xef340a98172aace5,  -715}, {0xb23867fb2a35b28e,  -688},
+	{0x84c8d4dfd2c63f3b,  -661}, {0xc5dd44271ad3cdba,  -635}, {0x936b9fcebb25c996,  -608},
+	{0xdbac6c247d62a584,  -582}, {0xa3ab66580d5fdaf6,  -555}, {0xf3e2f893dec3f126,  -529},
+	{0xb5b5ada8aaff80b8,  -502}, {0x87625f056c7c4a8b,  -475}, {0xc9bcff6034c13053,  -449},
+	{0x964e858c91ba2655,  -422}, {0xdff9772470297ebd,  -396}, {0xa6dfbd9fb8e5b88f,  -369},
+	{0xf8a95fcf88747d94,  -343}, {0xb94470938fa89bcf,  -316}, {0x8a08f0f8bf0f156b,  -289},
+	{0xcdb02555653131b6,  -263}, {0x993fe2c6d07b7fac,  -236}, {0xe45c10c42a2b3b06,  -210},
+	{0xaa242499697392d3,  -183}, {0xfd87b5f28300ca0e,  -157}, {0xbce5086492111aeb,  -130},
+	{0x8cbccc096f5088cc,  -103}, {0xd1b71758e219652c,   -77}, {0x9c40000000000000,   -50},
+	{0xe8d4a51000000000,   -24}, {0xad78ebc5ac620000,     3}, {0x813f3978f8940984,    30},
+	{0xc097ce7bc90715b3,    56}, {0x8f7e32ce7bea5c70,    83}, {0xd5d238a4abe98068,   109},
+	{0x9f4f2726179a2245,   136}, {0xed63a231d4c4fb27,   162}, {0xb0de65388cc8ada8,   189},
+	{0x83c7088e1aab65db,   216}, {0xc45d1df942711d9a,   242}, {0x924d692ca61be758,   269},
+	{0xda01ee641a708dea,   295}, {0xa26da3999aef774a,   322}, {0xf209787bb47d6b85,   348},
+	{0xb454e4a179dd1877,   375}, {0x865b86925b9bc5c2,   402}, {0xc83553c5c8965d3d,   428},
+	{0x952ab45cfa97a0b3,   455}, {0xde469fbd99a05fe3,   481}, {0xa59bc234db398c25,   508},
+	{0xf6c69a72a3989f5c,   534}, {0xb7dcbf5354e9bece,   561}, {0x88fcf317f22241e2,   588},
+	{0xcc20ce9bd35c78a5,   614}, {0x98165af37b2153df,   641}, {0xe2a0b5dc971f303a,   667},
+	{0xa8d9d1535ce3b396,   694}, {0xfb9b7cd9a4a7443c,   720}, {0xbb764c4ca7a44410,   747},
+	{0x8bab8eefb6409c1a,   774}, {0xd01fef10a657842c,   800}, {0x9b10a4e5e9913129,   827},
+	{0xe7109bfba19c0c9d,   853}, {0xac2820d9623bf429,   880}, {0x80444b5e7aa7cf85,   907},
+	{0xbf21e44003acdd2d,   933}, {0x8e679c2f5e44ff8f,   960}, {0xd433179d9c8cb841,   986},
+	{0x9e19db92b4e31ba9,  1013}, {0xeb96bf6ebadf77d9,  1039}, {0xaf87023b9bf0ee6b,  1066},
+};
+
+const int CACHED_POWERS_MIN_K(-348);
+const int CACHED_POWERS_STEP(8);
+
+/* c = 10^-k with c * 2^e in a range DigitGen can work with */
+DiyFp cached_power(int e, int & k)
+{
+	// 1 / log2(10)
+	double dk((-61 - e) * 0.30102999566398114 + 347);
+	int ik(dk);
+	if (dk - ik > 0.0) {
+		ik++;
+	}
+
+	unsigned index((ik >> 3) + 1);
+	k = -(CACHED_POWERS_MIN_K + int(index) * CACHED_POWERS_STEP);
+	return DiyFp(CACHED_POWERS[index].f, CACHED_POWERS[index].e);
+}
+
+const uint64_t POW10[] = {
+	1ULL,
+	10ULL,
+	100ULL,
+	1000ULL,
+	10000ULL,
+	100000ULL,
+	1000000ULL,
+	10000000ULL,
+	100000000ULL,
+	1000000000ULL,
+	10000000000ULL,
+	100000000000ULL,
+	1000000000000ULL,
+	10000000000000ULL,
+	100000000000000ULL,
+	1000000000000000ULL,
+	10000000000000000ULL,
+	100000000000000000ULL,
+	1000000000000000000ULL,
+	10000000000000000000ULL,
+};
+
+int count_digits(uint32_t n)
+{
+	int res(1);
+	while (n >= 10) {
+		n /= 10;
+		++res;
+	}
+	return res;
+}
+
+/*
+ * Move the last digit towards w while staying inside the unsafe
+ * interval. Distances are in units of the scaled inputs, which
+ * are off by up to unit each. False if the result is not proven
+ * to be inside the rounding interval and closest to w.
+ */
+bool round_weed(char *buf, int len, uint64_t too_high_w, uint64_t unsafe,
+	uint64_t rest, uint64_t ten_kappa, uint64_t unit)
+{
+	const uint64_t small(too_high_w - unit);
+	const uint64_t big(too_high_w + unit);
+	while (rest < small && unsafe - rest >= ten_kappa &&
+	       (rest + ten_kappa < small || small - rest >= rest + ten_kappa - small)) {
+		buf[len - 1]--;
+		rest += ten_kappa;
+	}
+
+	if (rest < big && unsafe - rest >= ten_kappa &&
+	    (rest + ten_kappa < big || big - rest > rest + ten_kappa - big)) {
+		return false;
+	}
+
+	return 2 * unit <= rest && rest <= unsafe - 4 * unit;
+}
+
+/* shortest digits of a number in (low, high), closest to w */
+bool digit_gen(DiyFp const& low, DiyFp const& w, DiyFp const& high,
+	char *buf, int & len, int & k)
+{
+	uint64_t unit(1);
+	const DiyFp too_low(low.f - unit, low.e);
+	const DiyFp too_high(high.f + unit, high.e);
+	uint64_t unsafe((too_high - too_low).f);
+	const DiyFp one(uint64_t(1) << -w.e, w.e);
+	uint32_t p1(too_high.f >> -one.e);
+	uint64_t p2(too_high.f & (one.f - 1));
+	int kappa(count_digits(p1));
+	len = 0;
+
+	while (kappa > 0) {
+		uint32_t d(p1 / POW10[kappa - 1]);
+		p1 %= POW10[kappa - 1];
+		buf[len++] = '0' + d;
+		kappa--;
+
+		uint64_t rest((uint64_t(p1) << -one.e) + p2);
+		if (rest < unsafe) {
+			k += kappa;
+			return round_weed(buf, len, (too_high - w).f, unsafe,
+				rest, POW10[kappa] << -one.e, unit);
+		}
+	}
+
+	for (;;) {
+		p2 *= 10;
+		unit *= 10;
+		unsafe *= 10;
+		buf[len++] = '0' + char(p2 >> -one.e);
+		p2 &= one.f - 1;
+		kappa--;
+		if (p2 < unsafe) {
+			k += kappa;
+			return round_weed(buf, len, (too_high - w).f * unit, unsafe,
+				p2, one.f, unit);
+		}
+	}
+}
+
+/* value = digits * 10^k, value > 0, false if undecided */
+bool grisu3(double value, char *buf, int & len, int & k)
+{
+	const DiyFp v(value);
+	DiyFp m_minus(0, 0), m_plus(0, 0);
+	v.boundaries(m_minus, m_plus);
+
+	const DiyFp c_mk(cached_power(m_plus.e, k));
+	return digit_gen(m_minus * c_mk, v.normalize() * c_mk, m_plus * c_mk,
+		buf, len, k);
+}
+
+double read_back(char const* buf, int len, int k)
+{
+	char str[Json::DTOA_BUFSIZE];
+	snprintf(str, sizeof(str), "%.*se%d", len, buf, k);
+	return strtod(str, nullptr);
+}
+
+/* next len digit number below or above */
+void next_digits(char *buf, int len, int & k, bool up)
+{
+	const char from(up ? '9' : '0');
+	int i(len - 1);
+	for (; i >= 0 && buf[i] == from; --i) {
+		buf[i] = up ? '0' : '9';
+	}
+
+	if (i >= 0 && !(i == 0 && !up && buf[0] == '1')) {
+		buf[i] += up ? 1 : -1;
+	} else if (up) {
+		// 999 -> 100e1
+		buf[0] = '1';
+		k++;
+	} else {
+		// 100 -> 999e-1
+		buf[0] = '9';
+		k--;
+	}
+}
+
+/*
+ * Exact digits for what grisu3() rejects, starting at its length:
+ * no shorter number lies in the wider interval it searched. value
+ * lies between two numbers of len digits, printf() rounds to the
+ * nearer one. If neither reads back as value, none of len digits
+ * does.
+ */
+void shortest(double value, char *buf, int & len, int & k)
+{
+	Json::AutoLocale lc("C");
+	char str[Json::DTOA_BUFSIZE];
+	for (; len <= 17; ++len) {
+		// d.ddde+x
+		snprintf(str, sizeof(str), "%.*e", len - 1, value);
+		buf[0] = str[0];
+		memcpy(&buf[1], &str[2], len - 1);
+		k = atoi(&str[len == 1 ? 2 : len + 2]) - (len - 1);
+
+		const double nearer(read_back(buf, len, k));
+		if (nearer == value) {
+			return;
+		}
+
+		next_digits(buf, len, k, nearer < value);
+		if (read_back(buf, len, k) == value) {
+			return;
+		}
+	}
+	assert(false); // LCOV_EXCL_LINE
+}
+
+/* value = digits * 10^k, value > 0 */
+void shortest_digits(double value, char *buf, int & len, int & k)
+{
+	if (!grisu3(value, buf, len, k)) {
+		shortest(value, buf, len, k);
+	}
+}
+
+long double read_back_long(char const* buf, int len, int k)
+{
+	char str[Json::DTOA_BUFSIZE];
+	snprintf(str, sizeof(str), "%.*se%d", len, buf, k);
+	return strtold(str, nullptr);
+}
+
+/*
+ * value = digits * 10^k, value > 0, for a long double that is
+ * no double: the fewest digits printf() rounds to that read back.
+ */
+void shortest_long(long double value, char *buf, int & len, int & k)
+{
+	const int digits(std::numeric_limits<long double>::max_digits10);
+	static_assert(digits + 12 <= int(Json::DTOA_BUFSIZE),
+		"DTOA_BUFSIZE too small");
+	char str[Json::DTOA_BUFSIZE];
+	for (len = 1; ; ++len) {
+		// d.ddde+x
+		snprintf(str, sizeof(str), "%.*Le", len - 1, value);
+		if (len == digits || strtold(str, nullptr) == value) {
+			break;
+		}
+	}
+	buf[0] = str[0];
+	memcpy(&buf[1], &str[2], len - 1);
+	k = atoi(&str[len == 1 ? 2 : len + 2]) - (len - 1);
+}
+
+char *write_exponent(int k, char *buf)
+{
+	*buf++ = 'e';
+	if (k < 0) {
+		*buf++ = '-';
+		k = -k;
+	} else {
+		*buf++ = '+';
+	}
+
+	if (k >= 1000) {
+		// long double only
+		*buf++ = '0' + k / 1000;
+		k %= 1000;
+		*buf++ = '0' + k / 100;
+		k %= 100;
+		*buf++ = '0' + k / 10;
+	} else if (k >= 100) {
+		*buf++ = '0' + k / 100;
+		k %= 100;
+		*buf++ = '0' + k / 10;
+	} else if (k >= 10) {
+		*buf++ = '0' + k / 10;
+	}
+	*buf++ = '0' + k % 10;
+	return buf;
+}
+
+/* lay out len digits times 10^k in buf, integers end in ".0" unless es */
+char *prettify(char *buf, int len, int k, bool es)
+{
+	const int kk(len + k); // 10^(kk - 1) <= v < 10^kk
+
+	if (k >= 0 && kk <= 21) {
+		// 1234e7 -> 12340000000.0
+		for (int i(len); i < kk; ++i) {
+			buf[i] = '0';
+		}
+		if (es) {
+			return &buf[kk];
+		}
+		buf[kk] = '.';
+		buf[kk + 1] = '0';
+		return &buf[kk + 2];
+	} else if (kk > 0 && kk <= 21) {
+		// 1234e-2 -> 12.34
+		memmove(&buf[kk + 1], &buf[kk], len - kk);
+		buf[kk] = '.';
+		return &buf[len + 1];
+	} else if (kk > -6 && kk <= 0) {
+		// 1234e-6 -> 0.001234
+		const int offset(2 - kk);
+		memmove(&buf[offset], &buf[0], len);
+		buf[0] = '0';
+		buf[1] = '.';
+		for (int i(2); i < offset; ++i) {
+			buf[i] = '0';
+		}
+		return &buf[len + offset];
+	} else if (len == 1) {
+		// 1e30
+		return write_exponent(kk - 1, &buf[1]);
+	}
+
+	// 1234e30 -> 1.234e+33
+	memmove(&buf[2], &buf[1], len - 1);
+	buf[1] = '.';
+	return write_exponent(kk - 1, &buf[len + 1]);
+}
+
+}
+
+namespace Json {
+
+size_t dtoa(double value, char *buf)
+{
+	assert(std::isfinite(value));
+	auto start(buf);
+	if (std::signbit(value)) {
+		*buf++ = '-';
+		value = -value;
+	}
+
+	if (value == 0.0) {
+		memcpy(buf, "0.0", 3);
+		return buf + 3 - start;
+	}
+
+	int len, k;
+	shortest_digits(value, buf, len, k);
+	return prettify(buf, len, k, false) - start;
+}
+
+size_t ldtoa(long double value, char *buf)
+{
+	assert(std::isfinite(value));
+	const double d(value);
+	if (d == value) {
+		return dtoa(d, buf);
+	}
+
+	auto start(buf);
+	if (std::signbit(value)) {
+		*buf++ = '-';
+		value = -value;
+	}
+
+	AutoLocale lc("C");
+	int len, k;
+	if (std::isfinite(d) && d != 0.0) {
+		// parsed from few digits, those of the double read back
+		shortest_digits(std::fabs(d), buf, len, k);
+		if (read_back_long(buf, len, k) == value) {
+			return prettify(buf, len, k, false) - start;
+		}
+	}
+
+	shortest_long(value, buf, len, k);
+	return prettify(buf, len, k, false) - start;
+}
+
+size_t dtoa_es(double value, char *buf)
+{
+	assert(std::isfinite(value));
+	if (value == 0.0) {
+		*buf = '0';
+		return 1;
+	}
+
+	auto start(buf);
+	if (value < 0.0) {
+		*buf++ = '-';
+		value = -value;
+	}
+
+	int len, k;
+	shortest_digits(value, buf, len, k);
+	return prettify(buf, len, k, true) - start;
+}
+
+}
@@ -0,0 +1,45 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#ifndef JSONCC_DTOA_H
+#define JSONCC_DTOA_H
+
+#include <cstddef>
+
+namespace Json {
+
+/* large enough for any output of dtoa() and ldtoa() */
+const size_t DTOA_BUFSIZE = 48;
+
+/*
+ * Format value with the fewest digits that read back as the
+ * same double, the nearest to value if several qualify (Grisu3
+ * with an exact fallback). The result always carries a fraction
+ * or an exponent, so it is scanned as a float again:
+ *
+ *   1.0  0.5  123.456  0.00001  1e+300  1.5e-7
+ *
+ * value must be finite, JSON has no nan or inf.
+ * Returns the length, buf is not zero terminated.
+ */
+size_t dtoa(double value, char *buf);
+
+/*
+ * dtoa() of value if it is exactly a double. Otherwise, as for
+ * 0.1L or 1e+400, the fewest digits that read back as the same
+ * long double in the same layout. value must be finite.
+ */
+size_t ldtoa(long double value, char *buf);
+
+/*
+ * Same digits in the layout of ECMAScript Number.prototype.toString()
+ * as required by RFC 8785: integers have no fraction and -0.0 is
+ * "0". value must be finite.
+ */
+size_t dtoa_es(double value, char *buf);
+
+}
+
+#endif
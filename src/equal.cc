@@ -5,10 +5,127 @@
 */
 
 #include <algorithm>
+#include <string>
 #include <jsoncc.h>
 
+#include "compare.h"
+
+namespace {
+
+// objects from this size on are compared by sorted keys
+const size_t SORT_SIZE(8);
+
+bool key_less(Json::Member const* l, Json::Member const* r)
+{
+	return Json::compare(l->key(), r->key()) < 0;
+}
+
+bool value_equal(Json::Member const* l, Json::Member const* r)
+{
+	return Json::equal(l->value(), r->value());
+}
+
+enum Match {
+	MATCH,
+	MISMATCH,
+	UNDECIDED,
+};
+
+size_t key_count(Json::Object const& object, Json::String const& key)
+{
+	size_t res(0);
+	for (auto const& member: object) {
+		res += Json::compare(member.key(), key) == 0;
+	}
+	return res;
+}
+
+/*
+ * Compare members pairwise if both objects have the same keys
+ * in the same order, the common case which needs neither
+ * sorting nor allocation. Only a mismatch on a duplicate key
+ * is left undecided.
+ */
+Match match_in_order(Json::Object const& l, Json::Object const& r)
+{
+	auto rit(r.begin());
+	for (auto lit(l.begin()); lit != l.end(); ++lit, ++rit) {
+		if (Json::compare(lit->key(), rit->key()) != 0) {
+			return UNDECIDED;
+		}
+	}
+
+	rit = r.begin();
+	for (auto lit(l.begin()); lit != l.end(); ++lit, ++rit) {
+		if (!Json::equal(lit->value(), rit->value())) {
+			return key_count(l, lit->key()) == 1 ? MISMATCH : UNDECIDED;
+		}
+	}
+
+	return MATCH;
+}
+
+/*
+ * Members are matched after sorting both sides by key. Runs
+ * of duplicate keys must have the same length and their values
+ * must be a permutation of each other.
+ */
+bool equal_sorted(Json::Object const& l, Json::Object const& r)
+{
+	auto lm(Json::sorted_members(l));
+	auto rm(Json::sorted_members(r));
+
+	for (size_t begin(0), end(0); begin < lm.size(); begin = end) {
+		auto const& key(lm[begin]->key());
+		for (end = begin; end < lm.size() && Json::compare(lm[end]->key(), key) == 0; ++end) {
+			if (Json::compare(rm[end]->key(), key) != 0) {
+				return false;
+			}
+		}
+
+		if (end < rm.size() && Json::compare(rm[end]->key(), key) == 0) {
+			return false;
+		}
+
+		if (end - begin == 1) {
+			if (!value_equal(lm[begin], rm[begin])) {
+				return false;
+			}
+		} else if (!std::is_permutation(
+				lm.begin() + begin, lm.begin() + end,
+				rm.begin() + begin, value_equal)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+}
+
 namespace Json {
 
+int compare(String const& l, String const& r)
+{
+	auto res(std::char_traits<char>::compare(
+		l.data(), r.data(), std::min(l.size(), r.size())));
+	if (res != 0) {
+		return res;
+	}
+	return l.size() < r.size() ? -1 : (l.size() > r.size() ? 1 : 0);
+}
+
+std::vector<Member const*> sorted_members(Object const& object)
+{
+	std::vector<Member const*> res;
+	res.reserve(object.size());
+	for (auto const& member: object) {
+		res.push_back(&member);
+	}
+	std::stable_sort(res.begin(), res.end(), key_less);
+	return res;
+}
+
 bool equal(Null const&, Null const&)
 {
 	return true;
@@ -50,7 +167,8 @@ bool equal(Number const& l, Number const& r)
 
 bool equal(String const& l, String const& r)
 {
-	return (&l == &r) || (l.value() == r.value());
+	return (&l == &r) || (l.size() == r.size() &&
+		std::equal(l.data(), l.data() + l.size(), r.data()));
 }
 
 bool equal(Array const& l, Array const& r)
@@ -63,6 +181,15 @@ bool equal(Array const& l, Array const& r)
 		return false;
 	}
 
+	if (l.storage() == r.storage()) {
+		switch (l.storage()) {
+		case Array::STORAGE_VALUES: break;
+		case Array::STORAGE_INT:    return l.int_values() == r.int_values();
+		case Array::STORAGE_UINT:   return l.uint_values() == r.uint_values();
+		case Array::STORAGE_FP:     return l.fp_values() == r.fp_values();
+		}
+	}
+
 	using value_eq = bool(*)(Value const&, Value const&);
 	return equal(
 		std::begin(l), std::end(l),
@@ -84,6 +211,16 @@ bool equal(Object const& l, Object const& r)
 		return false;
 	}
 
+	switch (match_in_order(l, r)) {
+	case MATCH:     return true;
+	case MISMATCH:  return false;
+	case UNDECIDED: break;
+	}
+
+	if (l.size() >= SORT_SIZE) {
+		return equal_sorted(l, r);
+	}
+
 	using member_eq = bool(*)(Member const&, Member const&);
 	return is_permutation(
 		std::begin(l), std::end(l),
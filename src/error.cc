@@ -31,6 +31,15 @@ static const char *error_message[] = {
 	"bad or missing  value in object member",
 	"expected ',' or '}' after object member",
 	"object contains bad member",
+	"document is not an array of objects",
+	"value does not match column type",
+	"writer call does not match document structure",
+	"writing to file descriptor failed",
+	"number has no canonical form (nan, inf)",
+	"value does not match the type read",
+	"malformed patch operation",
+	"patch path does not exist",
+	"patch test operation failed",
 	"internal error",
 };
 
@@ -3,5 +3,9 @@
    Use of this source code is governed by a BSD-style
    license that can be found in the LICENSE file.
 */
+#ifndef JSONCC_ERROR_H
+#define JSONCC_ERROR_H
 
 #define JSONCC_THROW(type) throw Json::Error(Json::Error::type)
+
+#endif
@@ -0,0 +1,214 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <jsoncc.h>
+#include "error.h"
+
+namespace {
+
+#ifdef IOV_MAX
+const size_t MAX_IOV(IOV_MAX);
+#else
+const size_t MAX_IOV(1024);
+#endif
+
+/* write all of iov, retrying partial writes */
+void writev_all(int fd, iovec *iov, size_t count)
+{
+	while (count) {
+		auto res(::writev(fd, iov, std::min(count, MAX_IOV)));
+		if (res < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			JSONCC_THROW(WRITE_FAILED);
+		}
+
+		size_t done(res);
+		while (count && done >= iov->iov_len) {
+			done -= iov->iov_len;
+			++iov;
+			--count;
+		}
+
+		if (count) {
+			iov->iov_base = static_cast<char *>(iov->iov_base) + done;
+			iov->iov_len -= done;
+		}
+	}
+}
+
+}
+
+namespace Json {
+
+/*
+ * The ring is filled buffer by buffer. Pending output is kept
+ * as a list of iovecs, a segment of the current buffer is
+ * closed when a reference is appended or the buffer is left.
+ */
+class FdSinkImpl {
+public:
+	FdSinkImpl(int fd, size_t buffer_count, size_t buffer_size, size_t min_reference)
+	:
+		fd_(fd),
+		buffer_size_(buffer_size),
+		min_reference_(min_reference),
+		ring_(buffer_count * buffer_size),
+		current_(0),
+		fill_(0),
+		segment_(0),
+		iov_()
+	{
+		assert(buffer_count > 0 && buffer_size > 0);
+		iov_.reserve(2 * buffer_count);
+	}
+
+	/* copied into the ring unless it would fill all of it */
+	void write(char const *data, size_t size)
+	{
+		if (size >= ring_.size()) {
+			add_iov(data, size);
+			flush();
+			return;
+		}
+
+		while (size) {
+			if (fill_ == buffer_size_) {
+				next_buffer();
+			}
+
+			auto len(std::min(size, buffer_size_ - fill_));
+			memcpy(buffer() + fill_, data, len);
+			fill_ += len;
+			data += len;
+			size -= len;
+		}
+	}
+
+	/* false if data was copied or written already */
+	bool write_reference(char const *data, size_t size)
+	{
+		if (min_reference_ == 0 || size < min_reference_) {
+			write(data, size);
+			return false;
+		}
+
+		add_iov(data, size);
+		if (iov_.size() >= MAX_IOV) {
+			flush();
+			return false;
+		}
+		return true;
+	}
+
+	size_t buffer_size() const
+	{
+		return buffer_size_;
+	}
+
+	/* pending output is dropped on errors */
+	void flush()
+	{
+		close_segment();
+		try {
+			writev_all(fd_, iov_.data(), iov_.size());
+		} catch (Error const&) {
+			reset();
+			throw;
+		}
+		reset();
+	}
+
+private:
+	void reset()
+	{
+		iov_.clear();
+		current_ = fill_ = segment_ = 0;
+	}
+
+	char *buffer()
+	{
+		return &ring_[current_ * buffer_size_];
+	}
+
+	void add_iov(char const *data, size_t size)
+	{
+		close_segment();
+		iov_.push_back(iovec{const_cast<char *>(data), size});
+	}
+
+	void close_segment()
+	{
+		if (fill_ > segment_) {
+			iov_.push_back(iovec{buffer() + segment_, fill_ - segment_});
+			segment_ = fill_;
+		}
+	}
+
+	void next_buffer()
+	{
+		if ((current_ + 1) * buffer_size_ == ring_.size()) {
+			flush();
+			return;
+		}
+
+		close_segment();
+		++current_;
+		fill_ = segment_ = 0;
+	}
+
+	int fd_;
+	size_t buffer_size_;
+	size_t min_reference_;
+	std::vector<char> ring_;
+	size_t current_;
+	size_t fill_;
+	size_t segment_;
+	std::vector<iovec> iov_;
+};
+
+FdSink::FdSink(int fd, size_t buffer_count, size_t buffer_size, size_t min_reference)
+:
+	impl_(new FdSinkImpl(fd, buffer_count, buffer_size, min_reference))
+{ }
+
+FdSink::~FdSink()
+{
+	try {
+		impl_->flush();
+	} catch (Error const&) {
+	}
+}
+
+void FdSink::write(char const *data, size_t size)
+{
+	impl_->write(data, size);
+}
+
+bool FdSink::write_reference(char const *data, size_t size)
+{
+	return impl_->write_reference(data, size);
+}
+
+void FdSink::flush()
+{
+	impl_->flush();
+}
+
+size_t FdSink::chunk_size() const
+{
+	return impl_->buffer_size();
+}
+
+}
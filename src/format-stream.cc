@@ -0,0 +1,117 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <locale>
+#include <streambuf>
+
+#include <jsoncc.h>
+
+namespace Json {
+
+/* streambuf appending to a string which keeps its capacity */
+class StringBuf : public std::streambuf {
+public:
+	StringBuf()
+	:
+		str()
+	{ }
+
+	std::string str;
+
+protected:
+	int_type overflow(int_type c)
+	{
+		if (!traits_type::eq_int_type(c, traits_type::eof())) {
+			str.push_back(traits_type::to_char_type(c));
+		}
+		return traits_type::not_eof(c);
+	}
+
+	std::streamsize xsputn(char const *data, std::streamsize size)
+	{
+		str.append(data, size);
+		return size;
+	}
+};
+
+class FormatStreamImpl {
+public:
+	FormatStreamImpl()
+	:
+		busy(false),
+		buf(),
+		os(&buf),
+		classic(std::locale::classic())
+	{
+		os.imbue(classic);
+	}
+
+	void reset()
+	{
+		buf.str.clear();
+		os.clear();
+		os.exceptions(std::ios_base::goodbit);
+		os.flags(std::ios_base::dec | std::ios_base::skipws);
+		os.precision(6);
+		os.width(0);
+		os.fill(' ');
+		if (os.getloc() != classic) {
+			os.imbue(classic);
+		}
+		indent(os);
+	}
+
+	bool busy;
+	StringBuf buf;
+	std::ostream os;
+	std::locale classic;
+};
+
+namespace {
+
+thread_local FormatStreamImpl format_stream;
+
+}
+
+FormatStream::FormatStream()
+:
+	impl_(nullptr),
+	nested_()
+{
+	if (format_stream.busy) {
+		nested_.reset(new std::stringstream());
+		nested_->imbue(std::locale::classic());
+		return;
+	}
+
+	impl_ = &format_stream;
+	impl_->busy = true;
+	impl_->reset();
+}
+
+FormatStream::~FormatStream()
+{
+	if (impl_) {
+		impl_->busy = false;
+	}
+}
+
+std::ostream & FormatStream::stream()
+{
+	if (impl_) {
+		return impl_->os;
+	}
+	return *nested_;
+}
+
+String FormatStream::str() const
+{
+	if (impl_) {
+		return String(impl_->buf.str);
+	}
+	return String(nested_->str());
+}
+
+}
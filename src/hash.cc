@@ -0,0 +1,156 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cassert>
+#include <functional>
+
+#include <jsoncc.h>
+
+#include "xxhash.h"
+
+namespace {
+
+const uint64_t PRIME1(0x9e3779b185ebca87ULL);
+const uint64_t PRIME2(0xc2b2ae3d27d4eb4fULL);
+const uint64_t PRIME3(0x165667b19e3779f9ULL);
+
+uint64_t combine(uint64_t h, uint64_t v)
+{
+	h ^= v * PRIME2;
+	return ((h << 31) | (h >> 33)) * PRIME1 + PRIME3;
+}
+
+uint64_t avalanche(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= PRIME2;
+	h ^= h >> 29;
+	h *= PRIME3;
+	h ^= h >> 32;
+	return h;
+}
+
+uint64_t hash_number(Json::Number::Type type, uint64_t bits)
+{
+	return avalanche(combine(combine(Json::Value::TAG_NUMBER, type), bits));
+}
+
+// 0.0 and -0.0 are equal and hash the same
+uint64_t fp_bits(long double value)
+{
+	return std::hash<long double>()(value);
+}
+
+template <typename T>
+uint64_t hash_numbers(uint64_t h, std::vector<T> const& values,
+	Json::Number::Type type, uint64_t (*bits)(T))
+{
+	for (auto const& value: values) {
+		h = combine(h, hash_number(type, bits(value)));
+	}
+	return h;
+}
+
+uint64_t int_bits(int64_t value)
+{
+	return uint64_t(value);
+}
+
+uint64_t uint_bits(uint64_t value)
+{
+	return value;
+}
+
+uint64_t double_bits(double value)
+{
+	return fp_bits(value);
+}
+
+}
+
+namespace Json {
+
+uint64_t hash(Number const& number)
+{
+	switch (number.type()) {
+	case Number::TYPE_INVALID:
+		return hash_number(number.type(), 0);
+	case Number::TYPE_INT:
+		return hash_number(number.type(), number.int_value());
+	case Number::TYPE_UINT:
+		return hash_number(number.type(), number.uint_value());
+	case Number::TYPE_FP:
+		return hash_number(number.type(), fp_bits(number.fp_value()));
+	}
+
+	assert(false); // LCOV_EXCL_LINE
+	return 0; // LCOV_EXCL_LINE
+}
+
+uint64_t hash(String const& string)
+{
+	XXH64 res(Value::TAG_STRING);
+	res.update(string.data(), string.size());
+	return res.digest();
+}
+
+uint64_t hash(Array const& array)
+{
+	auto res(combine(Value::TAG_ARRAY, array.size()));
+
+	switch (array.storage()) {
+	case Array::STORAGE_VALUES:
+		for (auto const& element: array) {
+			res = combine(res, hash(element));
+		}
+		break;
+	case Array::STORAGE_INT:
+		res = hash_numbers(res, array.int_values(), Number::TYPE_INT, int_bits);
+		break;
+	case Array::STORAGE_UINT:
+		res = hash_numbers(res, array.uint_values(), Number::TYPE_UINT, uint_bits);
+		break;
+	case Array::STORAGE_FP:
+		res = hash_numbers(res, array.fp_values(), Number::TYPE_FP, double_bits);
+		break;
+	}
+
+	return avalanche(res);
+}
+
+uint64_t hash(Object const& object)
+{
+	// a sum does not depend on the order of the members
+	uint64_t sum(0);
+	for (auto const& member: object) {
+		sum += avalanche(combine(hash(member.key()), hash(member.value())));
+	}
+
+	return avalanche(combine(combine(Value::TAG_OBJECT, object.size()), sum));
+}
+
+uint64_t hash(Value const& value)
+{
+	switch (value.tag()) {
+	case Value::TAG_INVALID:
+	case Value::TAG_NULL:
+	case Value::TAG_TRUE:
+	case Value::TAG_FALSE:
+		return avalanche(combine(PRIME1, value.tag()));
+	case Value::TAG_NUMBER:
+		return hash(value.number());
+	case Value::TAG_STRING:
+		return hash(value.string());
+	case Value::TAG_OBJECT:
+		return hash(value.object());
+	case Value::TAG_ARRAY:
+		return hash(value.array());
+	}
+
+	assert(false); // LCOV_EXCL_LINE
+	return 0; // LCOV_EXCL_LINE
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cstring>
+
+#include "itoa.h"
+
+namespace {
+
+const char DIGIT_PAIRS[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+size_t count_digits(uint64_t value)
+{
+	size_t res(1);
+	for (;;) {
+		if (value < 10) {
+			return res;
+		}
+		if (value < 100) {
+			return res + 1;
+		}
+		if (value < 1000) {
+			return res + 2;
+		}
+		if (value < 10000) {
+			return res + 3;
+		}
+		value /= 10000;
+		res += 4;
+	}
+}
+
+}
+
+namespace Json {
+
+size_t u64toa(uint64_t value, char *buf)
+{
+	auto len(count_digits(value));
+	auto pos(buf + len);
+	while (value >= 100) {
+		auto pair((value % 100) * 2);
+		value /= 100;
+		pos -= 2;
+		memcpy(pos, &DIGIT_PAIRS[pair], 2);
+	}
+
+	if (value >= 10) {
+		memcpy(pos - 2, &DIGIT_PAIRS[value * 2], 2);
+	} else {
+		pos[-1] = '0' + value;
+	}
+	return len;
+}
+
+size_t i64toa(int64_t value, char *buf)
+{
+	if (value >= 0) {
+		return u64toa(value, buf);
+	}
+
+	*buf = '-';
+	// negate in unsigned, -INT64_MIN does not fit int64_t
+	return u64toa(~uint64_t(value) + 1, buf + 1) + 1;
+}
+
+}
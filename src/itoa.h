@@ -0,0 +1,27 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#ifndef JSONCC_ITOA_H
+#define JSONCC_ITOA_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Json {
+
+/* large enough for any output of u64toa() and i64toa() */
+const size_t ITOA_BUFSIZE = 20;
+
+/*
+ * Decimal representation of value, written two digits at a
+ * time from a table. Returns the length, buf is not zero
+ * terminated.
+ */
+size_t u64toa(uint64_t value, char *buf);
+size_t i64toa(int64_t value, char *buf);
+
+}
+
+#endif
@@ -0,0 +1,572 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cassert>
+#include <cstring>
+
+#include "parser-impl.h"
+
+#include "error.h"
+#include "token-stream.h"
+#include "utf8stream.h"
+
+namespace {
+
+bool is_ws(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool is_value_start(char c)
+{
+	return c != '\0' && strchr("[{\"tfn-0123456789", c) != nullptr;
+}
+
+bool is_structural(char c)
+{
+	return c != '\0' && strchr("]}:,", c) != nullptr;
+}
+
+bool is_number_char(char c)
+{
+	return c != '\0' && strchr("0123456789+-.eE", c) != nullptr;
+}
+
+/* printable ASCII without escapes, the source is the key */
+bool is_plain_key(char const *data, size_t size)
+{
+	for (size_t i(0); i < size; ++i) {
+		auto c(static_cast<unsigned char>(data[i]));
+		if (c < 0x20 || c >= 0x7f || c == '\\') {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* parse a single scalar token spanning the whole buffer */
+Json::Value parse_scalar(char const *data, size_t size)
+{
+	Json::Utf8Stream stream(data, size);
+	Json::TokenStream tokenizer(stream);
+
+	tokenizer.scan();
+	Json::Value res(Json::token_value(tokenizer.token));
+	tokenizer.scan();
+	if (tokenizer.token.type != Json::Token::END) {
+		JSONCC_THROW(NUMBER_INVALID);
+	}
+
+	return res;
+}
+
+}
+
+namespace Json {
+
+/*
+ * Flat table of the values in a document in source order.
+ * The children of a container start at the next index and
+ * are chained via Node::next, which points past the subtree.
+ */
+class LazyDocumentImpl {
+public:
+	struct Node {
+		Value::Tag tag;
+		size_t begin;
+		size_t end;
+		size_t key_begin;
+		size_t key_end;
+		bool key_plain;
+		size_t size;
+		size_t next;
+	};
+
+	LazyDocumentImpl(char const *, size_t);
+
+	bool empty() const;
+	Node const& node(size_t) const;
+	Value parse(size_t) const;
+	String key(size_t) const;
+	bool key_equal(size_t, std::string const&) const;
+
+private:
+	size_t scan_value(size_t, Error::Type);
+	void scan_array(size_t, size_t);
+	void scan_object(size_t, size_t);
+	void scan_string();
+	void scan_literal(char const *);
+	void scan_number();
+
+	void skip_ws();
+	char peek() const;
+	void expect_value(Error::Type) const;
+	void fail(Error::Type) const;
+
+	char const *data_;
+	size_t size_;
+	size_t pos_;
+	std::vector<Node> nodes_;
+};
+
+LazyDocumentImpl::LazyDocumentImpl(char const *data, size_t size)
+:
+	data_(data),
+	size_(size),
+	pos_(0),
+	nodes_()
+{
+	skip_ws();
+	if (pos_ == size_) {
+		return;
+	}
+
+	if (peek() != '[' && peek() != '{') {
+		fail(is_value_start(peek()) || is_structural(peek()) ?
+			Error::BAD_TOKEN_DOCUMENT : Error::TOKEN_INVALID);
+	}
+
+	scan_value(1, Error::BAD_TOKEN_DOCUMENT);
+
+	skip_ws();
+	if (pos_ != size_) {
+		fail(Error::BAD_TOKEN_DOCUMENT);
+	}
+}
+
+bool LazyDocumentImpl::empty() const
+{
+	return nodes_.empty();
+}
+
+LazyDocumentImpl::Node const& LazyDocumentImpl::node(size_t index) const
+{
+	assert(index < nodes_.size());
+	return nodes_[index];
+}
+
+Value LazyDocumentImpl::parse(size_t index) const
+{
+	auto const& n(node(index));
+	switch (n.tag) {
+	case Value::TAG_OBJECT:
+	case Value::TAG_ARRAY:
+		return ParserImpl().parse(data_ + n.begin, n.end - n.begin);
+	case Value::TAG_NULL:
+	case Value::TAG_TRUE:
+	case Value::TAG_FALSE:
+	case Value::TAG_NUMBER:
+	case Value::TAG_STRING:
+		return parse_scalar(data_ + n.begin, n.end - n.begin);
+	case Value::TAG_INVALID:
+		assert(false);                // LCOV_EXCL_LINE
+	}
+	JSONCC_THROW(INTERNAL_ERROR);         // LCOV_EXCL_LINE
+	return Value();
+}
+
+String LazyDocumentImpl::key(size_t index) const
+{
+	auto const& n(node(index));
+	if (n.key_plain) {
+		return String(std::string(data_ + n.key_begin, n.key_end - n.key_begin));
+	}
+
+	// validates escapes, UTF-8 and control characters, include the quotes
+	return parse_scalar(data_ + n.key_begin - 1, n.key_end - n.key_begin + 2).string();
+}
+
+bool LazyDocumentImpl::key_equal(size_t index, std::string const& key) const
+{
+	auto const& n(node(index));
+	if (!n.key_plain) {
+		return this->key(index).value() == key;
+	}
+
+	return n.key_end - n.key_begin == key.size() &&
+		memcmp(data_ + n.key_begin, key.data(), key.size()) == 0;
+}
+
+size_t LazyDocumentImpl::scan_value(size_t depth, Error::Type bad)
+{
+	expect_value(bad);
+
+	size_t index(nodes_.size());
+	nodes_.push_back(Node{Value::TAG_INVALID, pos_, pos_, 0, 0, false, 0, 0});
+
+	switch (peek()) {
+	case '[':
+		nodes_[index].tag = Value::TAG_ARRAY;
+		scan_array(index, depth);
+		break;
+	case '{':
+		nodes_[index].tag = Value::TAG_OBJECT;
+		scan_object(index, depth);
+		break;
+	case '"':
+		nodes_[index].tag = Value::TAG_STRING;
+		scan_string();
+		break;
+	case 't':
+		nodes_[index].tag = Value::TAG_TRUE;
+		scan_literal("true");
+		break;
+	case 'f':
+		nodes_[index].tag = Value::TAG_FALSE;
+		scan_literal("false");
+		break;
+	case 'n':
+		nodes_[index].tag = Value::TAG_NULL;
+		scan_literal("null");
+		break;
+	default:
+		nodes_[index].tag = Value::TAG_NUMBER;
+		scan_number();
+		break;
+	}
+
+	nodes_[index].end = pos_;
+	nodes_[index].next = nodes_.size();
+	return index;
+}
+
+void LazyDocumentImpl::scan_array(size_t index, size_t depth)
+{
+	if (depth > 255) {
+		fail(Error::PARSER_OVERFLOW);
+	}
+
+	++pos_;
+	skip_ws();
+	if (peek() == ']') {
+		++pos_;
+		return;
+	}
+
+	auto bad(Error::BAD_TOKEN_ARRAY_START);
+	for (;;) {
+		scan_value(depth + 1, bad);
+		++nodes_[index].size;
+
+		skip_ws();
+		switch (peek()) {
+		case ',':
+			++pos_;
+			skip_ws();
+			// a trailing comma is accepted, as by the Parser
+			if (peek() == ']') {
+				++pos_;
+				return;
+			}
+			bad = Error::BAD_TOKEN_ARRAY_NEXT;
+			break;
+		case ']':
+			++pos_;
+			return;
+		default:
+			fail(Error::BAD_TOKEN_ARRAY_VALUE);
+		}
+	}
+}
+
+void LazyDocumentImpl::scan_object(size_t index, size_t depth)
+{
+	if (depth > 255) {
+		fail(Error::PARSER_OVERFLOW);
+	}
+
+	++pos_;
+	skip_ws();
+	if (peek() == '}') {
+		++pos_;
+		return;
+	}
+
+	auto bad(Error::BAD_TOKEN_OBJECT_START);
+	for (;;) {
+		if (peek() != '"') {
+			fail(is_value_start(peek()) || is_structural(peek()) || pos_ == size_ ?
+				bad : Error::TOKEN_INVALID);
+		}
+
+		size_t key_begin(pos_ + 1);
+		scan_string();
+		size_t key_end(pos_ - 1);
+
+		skip_ws();
+		if (peek() != ':') {
+			fail(Error::BAD_TOKEN_OBJECT_NAME);
+		}
+		++pos_;
+		skip_ws();
+
+		auto member(scan_value(depth + 1, Error::BAD_TOKEN_OBJECT_SEP));
+		nodes_[member].key_begin = key_begin;
+		nodes_[member].key_end = key_end;
+		nodes_[member].key_plain =
+			is_plain_key(data_ + key_begin, key_end - key_begin);
+		++nodes_[index].size;
+
+		skip_ws();
+		switch (peek()) {
+		case ',':
+			++pos_;
+			skip_ws();
+			bad = Error::BAD_TOKEN_OBJECT_NEXT;
+			break;
+		case '}':
+			++pos_;
+			return;
+		default:
+			fail(Error::BAD_TOKEN_OBJECT_VALUE);
+		}
+	}
+}
+
+void LazyDocumentImpl::scan_string()
+{
+	for (++pos_; pos_ < size_; ++pos_) {
+		if (data_[pos_] == '"') {
+			++pos_;
+			return;
+		} else if (data_[pos_] == '\\') {
+			++pos_;
+		}
+	}
+
+	fail(Error::STRING_QUOTE);
+}
+
+void LazyDocumentImpl::scan_literal(char const *literal)
+{
+	auto len(strlen(literal));
+	if (size_ - pos_ < len || memcmp(data_ + pos_, literal, len) != 0) {
+		fail(Error::LITERAL_INVALID);
+	}
+	pos_ += len;
+}
+
+void LazyDocumentImpl::scan_number()
+{
+	while (pos_ < size_ && is_number_char(data_[pos_])) {
+		++pos_;
+	}
+}
+
+void LazyDocumentImpl::skip_ws()
+{
+	while (pos_ < size_ && is_ws(data_[pos_])) {
+		++pos_;
+	}
+}
+
+char LazyDocumentImpl::peek() const
+{
+	return pos_ < size_ ? data_[pos_] : '\0';
+}
+
+void LazyDocumentImpl::expect_value(Error::Type bad) const
+{
+	if (pos_ == size_ || is_structural(peek())) {
+		fail(bad);
+	}
+
+	if (!is_value_start(peek())) {
+		fail(Error::TOKEN_INVALID);
+	}
+}
+
+void LazyDocumentImpl::fail(Error::Type type) const
+{
+	throw Error(type, Location(pos_));
+}
+
+LazyValue::LazyValue()
+:
+	doc_(nullptr),
+	node_(0)
+{ }
+
+LazyValue::LazyValue(LazyDocumentImpl const* doc, size_t node)
+:
+	doc_(doc),
+	node_(node)
+{ }
+
+Value::Tag LazyValue::tag() const
+{
+	return doc_ ? doc_->node(node_).tag : Value::TAG_INVALID;
+}
+
+Number LazyValue::number() const
+{
+	assert(tag() == Value::TAG_NUMBER);
+	return doc_->parse(node_).number();
+}
+
+String LazyValue::string() const
+{
+	assert(tag() == Value::TAG_STRING);
+	return doc_->parse(node_).string();
+}
+
+LazyObject LazyValue::object() const
+{
+	assert(tag() == Value::TAG_OBJECT);
+	return LazyObject(*this);
+}
+
+LazyArray LazyValue::array() const
+{
+	assert(tag() == Value::TAG_ARRAY);
+	return LazyArray(*this);
+}
+
+Value LazyValue::value() const
+{
+	return doc_ ? doc_->parse(node_) : Value();
+}
+
+LazyMember::LazyMember(LazyValue const& value)
+:
+	value_(value)
+{ }
+
+String LazyMember::key() const
+{
+	return value_.doc_->key(value_.node_);
+}
+
+LazyValue LazyMember::value() const
+{
+	return value_;
+}
+
+LazyObject::const_iterator::const_iterator(LazyValue const& value)
+:
+	value_(value)
+{ }
+
+LazyMember LazyObject::const_iterator::operator*() const
+{
+	return LazyMember(value_);
+}
+
+LazyObject::const_iterator & LazyObject::const_iterator::operator++()
+{
+	value_.node_ = value_.doc_->node(value_.node_).next;
+	return *this;
+}
+
+bool LazyObject::const_iterator::operator==(const_iterator const& o) const
+{
+	return value_.doc_ == o.value_.doc_ && value_.node_ == o.value_.node_;
+}
+
+bool LazyObject::const_iterator::operator!=(const_iterator const& o) const
+{
+	return !(*this == o);
+}
+
+LazyObject::LazyObject(LazyValue const& value)
+:
+	value_(value)
+{ }
+
+size_t LazyObject::size() const
+{
+	return value_.doc_->node(value_.node_).size;
+}
+
+LazyValue LazyObject::member(std::string const& key) const
+{
+	for (auto it(begin()); it != end(); ++it) {
+		if (value_.doc_->key_equal(it.value_.node_, key)) {
+			return it.value_;
+		}
+	}
+	return LazyValue();
+}
+
+LazyObject::const_iterator LazyObject::begin() const
+{
+	return const_iterator(LazyValue(value_.doc_, value_.node_ + 1));
+}
+
+LazyObject::const_iterator LazyObject::end() const
+{
+	return const_iterator(LazyValue(value_.doc_, value_.doc_->node(value_.node_).next));
+}
+
+LazyArray::const_iterator::const_iterator(LazyValue const& value)
+:
+	value_(value)
+{ }
+
+LazyValue LazyArray::const_iterator::operator*() const
+{
+	return value_;
+}
+
+LazyArray::const_iterator & LazyArray::const_iterator::operator++()
+{
+	value_.node_ = value_.doc_->node(value_.node_).next;
+	return *this;
+}
+
+bool LazyArray::const_iterator::operator==(const_iterator const& o) const
+{
+	return value_.doc_ == o.value_.doc_ && value_.node_ == o.value_.node_;
+}
+
+bool LazyArray::const_iterator::operator!=(const_iterator const& o) const
+{
+	return !(*this == o);
+}
+
+LazyArray::LazyArray(LazyValue const& value)
+:
+	value_(value)
+{ }
+
+size_t LazyArray::size() const
+{
+	return value_.doc_->node(value_.node_).size;
+}
+
+LazyValue LazyArray::element(size_t index) const
+{
+	assert(index < size());
+	auto it(begin());
+	while (index--) {
+		++it;
+	}
+	return *it;
+}
+
+LazyArray::const_iterator LazyArray::begin() const
+{
+	return const_iterator(LazyValue(value_.doc_, value_.node_ + 1));
+}
+
+LazyArray::const_iterator LazyArray::end() const
+{
+	return const_iterator(LazyValue(value_.doc_, value_.doc_->node(value_.node_).next));
+}
+
+LazyDocument::LazyDocument(char const *data, size_t size)
+:
+	impl_(new LazyDocumentImpl(data, size))
+{ }
+
+LazyDocument::~LazyDocument()
+{ }
+
+LazyValue LazyDocument::root() const
+{
+	return impl_->empty() ? LazyValue() : LazyValue(impl_.get(), 0);
+}
+
+}
@@ -20,18 +20,34 @@ Member::Member(Member const& o)
 	value_(o.value_)
 { }
 
-Member::Member(Member && o)
+Member::Member(Member && o) noexcept
 :
 	key_(std::move(o.key_)),
 	value_(std::move(o.value_))
 { }
 
-Member::Member(std::string const& key, Value const& value)
+Member::Member(String const& key, Value const& value)
 :
 	key_(key),
 	value_(value)
 {
-	assert(!key.empty());
+	assert(key.size() != 0);
+}
+
+Member::Member(String const& key, Value && value)
+:
+	key_(key),
+	value_(std::move(value))
+{
+	assert(key.size() != 0);
+}
+
+Member::Member(String && key, Value && value)
+:
+	key_(std::move(key)),
+	value_(std::move(value))
+{
+	assert(key_.size() != 0);
 }
 
 Member & Member::operator=(Member const& o)
@@ -43,7 +59,7 @@ Member & Member::operator=(Member const& o)
 	return *this;
 }
 
-Member & Member::operator=(Member && o)
+Member & Member::operator=(Member && o) noexcept
 {
 	if (&o != this) {
 		key_ = std::move(o.key_);
@@ -52,12 +68,17 @@ Member & Member::operator=(Member && o)
 	return *this;
 }
 
-String Member::key() const
+String const& Member::key() const
 {
 	return key_;
 }
 
-Value Member::value() const
+Value const& Member::value() const
+{
+	return value_;
+}
+
+Value & Member::value()
 {
 	return value_;
 }
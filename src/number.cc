@@ -20,7 +20,7 @@ Number::Number(Number const& o)
 	value_(o.value_)
 { }
 
-Number::Number(Number && o)
+Number::Number(Number && o) noexcept
 :
 	type_(std::move(o.type_)),
 	value_(std::move(o.value_))
@@ -123,7 +123,7 @@ Number & Number::operator=(Number const& o)
 	return *this;
 }
 
-Number & Number::operator=(Number && o)
+Number & Number::operator=(Number && o) noexcept
 {
 	if (&o != this) {
 		type_ = std::move(o.type_);
@@ -23,7 +23,7 @@ Object::Object(Object const& o)
 	members_(o.members_)
 { }
 
-Object::Object(Object && o)
+Object::Object(Object && o) noexcept
 :
 	members_(std::move(o.members_))
 { }
@@ -36,7 +36,7 @@ Object & Object::operator=(Object const& o)
 	return *this;
 }
 
-Object & Object::operator=(Object && o)
+Object & Object::operator=(Object && o) noexcept
 {
 	if (&o != this) {
 		members_ = std::move(o.members_);
@@ -56,6 +56,21 @@ Object & Object::operator<<(Member && member)
 	return *this;
 }
 
+void Object::reserve(size_t size)
+{
+	members_.reserve(size);
+}
+
+size_t Object::capacity() const
+{
+	return members_.capacity();
+}
+
+void Object::shrink_to_fit()
+{
+	members_.shrink_to_fit();
+}
+
 size_t Object::size() const
 {
 	return members_.size();
@@ -66,14 +81,49 @@ std::vector<Member> Object::members() const
 	return members_;
 }
 
-Value Object::member(std::string const& key) const
+namespace {
+
+template <typename Iterator>
+Iterator find_key(Iterator first, Iterator last, std::string const& key)
 {
+	return std::find_if(first, last,
+		[&key](Member const& m) {
+			auto const& k(m.key());
+			return k.size() == key.size() &&
+				std::equal(k.data(), k.data() + k.size(), key.data());
+		});
+}
+
+}
 
-	auto it(std::find_if(members_.begin(), members_.end(),
-		[key](Member const& m) { return m.key().value() == key; }));
+Value Object::member(std::string const& key) const
+{
+	auto it(find_key(members_.begin(), members_.end(), key));
 	return it != members_.end() ? it->value() : Value();
 }
 
+Value const* Object::find(std::string const& key) const
+{
+	auto it(find_key(members_.begin(), members_.end(), key));
+	return it != members_.end() ? &it->value() : nullptr;
+}
+
+Value * Object::find(std::string const& key)
+{
+	auto it(find_key(members_.begin(), members_.end(), key));
+	return it != members_.end() ? &it->value() : nullptr;
+}
+
+bool Object::erase(std::string const& key)
+{
+	auto it(find_key(members_.begin(), members_.end(), key));
+	if (it == members_.end()) {
+		return false;
+	}
+	members_.erase(it);
+	return true;
+}
+
 std::vector<Member>::const_iterator Object::begin() const
 {
 	return members_.begin();
@@ -84,4 +134,14 @@ std::vector<Member>::const_iterator Object::end() const
 	return members_.end();
 }
 
+std::vector<Member>::iterator Object::begin()
+{
+	return members_.begin();
+}
+
+std::vector<Member>::iterator Object::end()
+{
+	return members_.end();
+}
+
 }
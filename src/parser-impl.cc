@@ -6,6 +6,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <stack>
 
 #include "parser-impl.h"
 
@@ -32,18 +33,17 @@ struct Transition {
 template <typename T>
 class StateEngine : public T {
 public:
-	StateEngine(Json::TokenStream & tokenizer_, size_t depth)
-	: T(tokenizer_, depth) { }
+	StateEngine(Json::TokenStream & tokenizer_,
+		Json::ParserHandler & handler_, size_t depth)
+	: T(tokenizer_, handler_, depth) { }
 
-	Json::Value parse()
+	void parse()
 	{
 		auto state(T::SSTART);
 		do {
 			T::tokenizer.scan();
 			state = transition(T::tokenizer.token.type, state);
 		} while (state != T::SEND);
-
-		return T::result;
 	}
 
 private:
@@ -80,17 +80,19 @@ private:
 /* Base class for state engine configurations */
 class ParserState {
 protected:
-	ParserState(Json::TokenStream & tokenizer_, size_t depth)
-	: tokenizer(tokenizer_), depth_(depth + 1)
+	ParserState(Json::TokenStream & tokenizer_,
+		Json::ParserHandler & handler_, size_t depth)
+	: tokenizer(tokenizer_), handler(handler_), depth_(depth + 1)
 	{
 		if (depth > 255) {
 			JSONCC_THROW(PARSER_OVERFLOW);
 		}
 	}
 
-	Json::Value parse_value();
+	void parse_value();
 
 	Json::TokenStream & tokenizer;
+	Json::ParserHandler & handler;
 
 private:
 	size_t depth_;
@@ -99,8 +101,9 @@ private:
 /* State engine config for Json::Array */
 class ArrayState : public ParserState {
 protected:
-	ArrayState(Json::TokenStream & tokenizer_, size_t depth)
-	: ParserState(tokenizer_, depth) { }
+	ArrayState(Json::TokenStream & tokenizer_,
+		Json::ParserHandler & handler_, size_t depth)
+	: ParserState(tokenizer_, handler_, depth) { }
 
 	enum State {
 		SERROR = 0,
@@ -114,7 +117,7 @@ protected:
 	void build(State state)
 	{
 		switch (state) {
-		case SVALUE: result << parse_value(); break;
+		case SVALUE: parse_value();           break;
 		case SNEXT:  break;
 		case SEND:   break;
 		case SMAX:   assert(false);           // LCOV_EXCL_LINE
@@ -136,7 +139,6 @@ protected:
 		}
 	}
 
-	Json::Array result;
 	static Transition<State> transitions[SMAX][SMAX];
 };
 
@@ -151,8 +153,9 @@ Transition<ArrayState::State> ArrayState::transitions[SMAX][SMAX] = {
 /* State engine config for Json::Object */
 class ObjectState : public ParserState {
 protected:
-	ObjectState(Json::TokenStream & tokenizer_, size_t depth)
-	: ParserState(tokenizer_, depth) { }
+	ObjectState(Json::TokenStream & tokenizer_,
+		Json::ParserHandler & handler_, size_t depth)
+	: ParserState(tokenizer_, handler_, depth) { }
 
 	enum State {
 		SERROR = 0,
@@ -168,8 +171,8 @@ protected:
 	void build(State state)
 	{
 		switch (state) {
-		case SNAME:  key = tokenizer.token.str_value; break;
-		case SVALUE: result << Json::Member(key, parse_value()); break;
+		case SNAME:  handler.key(tokenizer.token); break;
+		case SVALUE: parse_value();                break;
 		case SNEXT:  break;
 		case SEND:   break;
 		case SSEP:   break;
@@ -194,8 +197,6 @@ protected:
 		}
 	}
 
-	std::string key;
-	Json::Object result;
 	static Transition<State> transitions[SMAX][SMAX];
 };
 
@@ -212,8 +213,9 @@ Transition<ObjectState::State> ObjectState::transitions[SMAX][SMAX] = {
 /* State engine config for a Json document */
 class DocState : public ParserState {
 protected:
-	DocState(Json::TokenStream & tokenizer_, size_t & depth)
-	: ParserState(tokenizer_, depth) { }
+	DocState(Json::TokenStream & tokenizer_,
+		Json::ParserHandler & handler_, size_t depth)
+	: ParserState(tokenizer_, handler_, depth) { }
 
 	enum State {
 		SERROR = 0,
@@ -226,7 +228,7 @@ protected:
 	void build(State state)
 	{
 		switch (state) {
-		case SVALUE: result = parse_value(); break;
+		case SVALUE: parse_value();           break;
 		case SEND:   break;
 		case SSTART: assert(false);           // LCOV_EXCL_LINE
 		case SERROR: assert(false);           // LCOV_EXCL_LINE
@@ -246,7 +248,6 @@ protected:
 		}
 	}
 
-	Json::Value result;
 	static Transition<State> transitions[SMAX][SMAX];
 };
 
@@ -258,24 +259,26 @@ Transition<DocState::State> DocState::transitions[SMAX][SMAX] = {
 };
 
 /* select recursive parser for nested constructs */
-Json::Value ParserState::parse_value()
+void ParserState::parse_value()
 {
 	switch (tokenizer.token.type) {
-	case Json::Token::TRUE_LITERAL:    return Json::True();
-	case Json::Token::FALSE_LITERAL:   return Json::False();
-	case Json::Token::NULL_LITERAL:    return Json::Null();
-	case Json::Token::STRING:          return tokenizer.token.str_value;
+	case Json::Token::TRUE_LITERAL:
+	case Json::Token::FALSE_LITERAL:
+	case Json::Token::NULL_LITERAL:
+	case Json::Token::STRING:
 	case Json::Token::NUMBER:
-		if (tokenizer.token.number_type == Json::Token::FLOAT) {
-			return Json::Number(tokenizer.token.float_value);
-		} else {
-			return Json::Number(tokenizer.token.int_value);
-		}
-		break;
+		handler.value(tokenizer.token);
+		return;
 	case Json::Token::BEGIN_ARRAY:
-		return StateEngine<ArrayState>(tokenizer, depth_).parse();
+		handler.begin_array();
+		StateEngine<ArrayState>(tokenizer, handler, depth_).parse();
+		handler.end_array();
+		return;
 	case Json::Token::BEGIN_OBJECT:
-		return StateEngine<ObjectState>(tokenizer, depth_).parse();
+		handler.begin_object();
+		StateEngine<ObjectState>(tokenizer, handler, depth_).parse();
+		handler.end_object();
+		return;
 	case Json::Token::END:             assert(false); // LCOV_EXCL_LINE
 	case Json::Token::INVALID:         assert(false); // LCOV_EXCL_LINE
 	case Json::Token::END_ARRAY:       assert(false); // LCOV_EXCL_LINE
@@ -284,20 +287,163 @@ Json::Value ParserState::parse_value()
 	case Json::Token::VALUE_SEPARATOR: assert(false); // LCOV_EXCL_LINE
 	}
 	JSONCC_THROW(INTERNAL_ERROR);                     // LCOV_EXCL_LINE
-	return Json::Value();
 }
 
+/*
+ * Handler building a Json::Value tree.
+ *
+ * Containers under construction are kept on a stack and
+ * moved into their parent once complete.
+ */
+class ValueBuilder : public Json::ParserHandler {
+public:
+	ValueBuilder()
+	:
+		result(),
+		stack_()
+	{ }
+
+	void value(Json::Token const& token)
+	{
+		add(Json::token_value(token));
+	}
+
+	void begin_array()
+	{
+		stack_.push(Frame(false));
+	}
+
+	void end_array()
+	{
+		assert(!stack_.empty() && !stack_.top().is_object);
+		Json::Value value(std::move(stack_.top().array));
+		stack_.pop();
+		add(std::move(value));
+	}
+
+	void begin_object()
+	{
+		stack_.push(Frame(true));
+	}
+
+	void key(Json::Token const& token)
+	{
+		assert(!stack_.empty() && stack_.top().is_object);
+		stack_.top().key = token.str_ref ?
+			Json::String::reference(token.str_ref, token.str_ref_size) :
+			Json::String(token.str_value);
+	}
+
+	void end_object()
+	{
+		assert(!stack_.empty() && stack_.top().is_object);
+		Json::Value value(std::move(stack_.top().object));
+		stack_.pop();
+		add(std::move(value));
+	}
+
+	Json::Value result;
+
+private:
+	struct Frame {
+		explicit Frame(bool is_object_)
+		: is_object(is_object_), key(), array(), object() { }
+
+		bool is_object;
+		Json::String key;
+		Json::Array array;
+		Json::Object object;
+	};
+
+	void add(Json::Value && value)
+	{
+		if (stack_.empty()) {
+			result = std::move(value);
+		} else if (stack_.top().is_object) {
+			stack_.top().object << Json::Member(stack_.top().key, std::move(value));
+		} else {
+			stack_.top().array << std::move(value);
+		}
+	}
+
+	std::stack<Frame> stack_;
+};
+
 }
 
 namespace Json {
 
+ParserHandler::~ParserHandler()
+{ }
+
+Value token_value(Token const& token)
+{
+	switch (token.type) {
+	case Token::TRUE_LITERAL:    return True();
+	case Token::FALSE_LITERAL:   return False();
+	case Token::NULL_LITERAL:    return Null();
+	case Token::STRING:
+		if (token.str_ref) {
+			return String::reference(token.str_ref, token.str_ref_size);
+		}
+		return String(token.str_value);
+	case Token::NUMBER:
+		if (token.number_type == Token::FLOAT) {
+			return Number(token.float_value);
+		} else {
+			return Number(token.int_value);
+		}
+		break;
+	case Token::END:             assert(false); // LCOV_EXCL_LINE
+	case Token::INVALID:         assert(false); // LCOV_EXCL_LINE
+	case Token::BEGIN_ARRAY:     assert(false); // LCOV_EXCL_LINE
+	case Token::BEGIN_OBJECT:    assert(false); // LCOV_EXCL_LINE
+	case Token::END_ARRAY:       assert(false); // LCOV_EXCL_LINE
+	case Token::END_OBJECT:      assert(false); // LCOV_EXCL_LINE
+	case Token::NAME_SEPARATOR:  assert(false); // LCOV_EXCL_LINE
+	case Token::VALUE_SEPARATOR: assert(false); // LCOV_EXCL_LINE
+	}
+	JSONCC_THROW(INTERNAL_ERROR);               // LCOV_EXCL_LINE
+	return Value();
+}
+
 /* Toplevel parser for a single document */
 Value ParserImpl::parse(char const * data, size_t size)
+{
+	ValueBuilder builder;
+	parse(data, size, builder);
+	return std::move(builder.result);
+}
+
+Value ParserImpl::parse_zerocopy(char const * data, size_t size)
+{
+	Utf8Stream utf8stream(data, size);
+	TokenStream tokenizer(utf8stream, TokenStream::STRING_REFERENCE);
+	ValueBuilder builder;
+	parse(tokenizer, builder);
+	return std::move(builder.result);
+}
+
+Value ParserImpl::parse_insitu(char * data, size_t size)
+{
+	Utf8Stream utf8stream(data, size);
+	TokenStream tokenizer(utf8stream, data);
+	ValueBuilder builder;
+	parse(tokenizer, builder);
+	return std::move(builder.result);
+}
+
+void ParserImpl::parse(char const * data, size_t size, ParserHandler & handler)
 {
 	Utf8Stream utf8stream(data, size);
 	TokenStream tokenizer(utf8stream);
+	parse(tokenizer, handler);
+}
+
+void ParserImpl::parse(TokenStream & tokenizer, ParserHandler & handler)
+{
 	try {
-		return StateEngine<DocState>(tokenizer, 0).parse();
+		StateEngine<DocState>(tokenizer, handler, 0).parse();
 	} catch (Error & e) {
 		throw;
 	}
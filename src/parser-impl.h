@@ -3,14 +3,48 @@
    Use of this source code is governed by a BSD-style
    license that can be found in the LICENSE file.
 */
+#ifndef JSONCC_PARSER_IMPL_H
+#define JSONCC_PARSER_IMPL_H
+
 #include <jsoncc.h>
 
 namespace Json {
 
+class Token;
+class TokenStream;
+
+/*
+ * Receives the events of a parse run in document order.
+ *
+ * The parser validates the grammar, a handler only sees
+ * well formed sequences. Scalar tokens (literals, numbers
+ * and strings) are passed to value(), object keys to key().
+ */
+class ParserHandler {
+public:
+	virtual ~ParserHandler();
+
+	virtual void value(Token const&) = 0;
+	virtual void begin_array() = 0;
+	virtual void end_array() = 0;
+	virtual void begin_object() = 0;
+	virtual void key(Token const&) = 0;
+	virtual void end_object() = 0;
+};
+
+/* Value of a scalar token (literal, number or string) */
+Value token_value(Token const&);
+
 class ParserImpl {
 public:
 	Value parse(char const *, size_t);
-	Value parse(char const *, size_t, Error &);
+	Value parse_zerocopy(char const *, size_t);
+	Value parse_insitu(char *, size_t);
+	void parse(char const *, size_t, ParserHandler &);
+	void parse(TokenStream &, ParserHandler &);
+	void parse(char const *, size_t, std::vector<Column> &);
 };
 
 }
+
+#endif
@@ -32,4 +32,49 @@ Value Parser::parse(char const * data, size_t size, Error & err)
 	return Value();
 }
 
+Value Parser::parse_zerocopy(char const * data, size_t size)
+{
+	return impl_->parse_zerocopy(data, size);
+}
+
+Value Parser::parse_zerocopy(char const * data, size_t size, Error & err)
+{
+	try {
+		return parse_zerocopy(data, size);
+	} catch (Error & e) {
+		err = e;
+	}
+	return Value();
+}
+
+Value Parser::parse_insitu(char * data, size_t size)
+{
+	return impl_->parse_insitu(data, size);
+}
+
+Value Parser::parse_insitu(char * data, size_t size, Error & err)
+{
+	try {
+		return parse_insitu(data, size);
+	} catch (Error & e) {
+		err = e;
+	}
+	return Value();
+}
+
+void Parser::parse_columns(char const * data, size_t size, std::vector<Column> & columns)
+{
+	impl_->parse(data, size, columns);
+}
+
+void Parser::parse_columns(char const * data, size_t size,
+	std::vector<Column> & columns, Error & err)
+{
+	try {
+		parse_columns(data, size, columns);
+	} catch (Error & e) {
+		err = e;
+	}
+}
+
 }
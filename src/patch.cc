@@ -0,0 +1,609 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <algorithm>
+#include <iterator>
+
+#include <jsoncc.h>
+
+#include "compare.h"
+#include "error.h"
+
+namespace {
+
+// element pairs up to which changed array parts are aligned
+const size_t MAX_ALIGN(1 << 20);
+
+// changed keys up to which duplicates are searched without sorting
+const size_t MAX_KEY_SCANS(8);
+
+typedef std::vector<std::string> Pointer;
+
+void append_key(std::string & path, Json::String const& key)
+{
+	path.push_back('/');
+	for (auto it(key.data()), end(key.data() + key.size()); it != end; ++it) {
+		switch (*it) {
+		case '~': path.append("~0"); break;
+		case '/': path.append("~1"); break;
+		default:  path.push_back(*it); break;
+		}
+	}
+}
+
+void append_index(std::string & path, size_t index)
+{
+	path.push_back('/');
+	path.append(std::to_string(index));
+}
+
+bool has_duplicates(std::vector<Json::Member const*> const& sorted)
+{
+	return std::adjacent_find(sorted.begin(), sorted.end(),
+		[](Json::Member const* l, Json::Member const* r) {
+			return Json::compare(l->key(), r->key()) == 0;
+		}) != sorted.end();
+}
+
+/* whether the keys of members are not duplicated in object */
+bool unique_keys(Json::Object const& object,
+	std::vector<Json::Member const*> const& members)
+{
+	if (members.size() > MAX_KEY_SCANS) {
+		return !has_duplicates(Json::sorted_members(object));
+	}
+
+	for (auto member: members) {
+		size_t count(0);
+		for (auto const& other: object) {
+			count += Json::compare(member->key(), other.key()) == 0;
+		}
+		if (count != 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool same_keys(Json::Object const& l, Json::Object const& r)
+{
+	if (l.size() != r.size()) {
+		return false;
+	}
+
+	auto rit(r.begin());
+	for (auto const& member: l) {
+		if (Json::compare(member.key(), rit->key()) != 0) {
+			return false;
+		}
+		++rit;
+	}
+	return true;
+}
+
+/*
+ * Collects the operations turning one value into another.
+ * path_ is the JSON Pointer of the values being compared.
+ */
+class Diff {
+public:
+	Diff()
+	:
+		ops(),
+		path_()
+	{ }
+
+	void value(Json::Value const& from, Json::Value const& to)
+	{
+		if (from.tag() != to.tag()) {
+			op("replace", &to);
+			return;
+		}
+
+		switch (from.tag()) {
+		case Json::Value::TAG_OBJECT:
+			object(from.object(), to.object());
+			break;
+		case Json::Value::TAG_ARRAY:
+			array(from.array(), to.array());
+			break;
+		default:
+			if (!Json::equal(from, to)) {
+				op("replace", &to);
+			}
+			break;
+		}
+	}
+
+	std::vector<Json::Value> ops;
+
+private:
+	enum Edit {
+		KEEP,
+		REMOVE,
+		ADD,
+	};
+
+	void op(char const* name, Json::Value const* value)
+	{
+		Json::Object res;
+		res.reserve(value ? 3 : 2);
+		res << Json::Member("op", Json::String(name));
+		res << Json::Member("path", Json::String(path_));
+		if (value) {
+			res << Json::Member("value", *value);
+		}
+		ops.push_back(Json::Value(std::move(res)));
+	}
+
+	void object(Json::Object const& from, Json::Object const& to)
+	{
+		auto mark(ops.size());
+		if (same_keys(from, to)) {
+			std::vector<Json::Member const*> changed;
+			auto tit(to.begin());
+			for (auto const& member: from) {
+				auto size(ops.size());
+				member_value(member, tit->value());
+				if (ops.size() != size) {
+					changed.push_back(&member);
+				}
+				++tit;
+			}
+			if (unique_keys(from, changed)) {
+				return;
+			}
+		} else {
+			auto fm(Json::sorted_members(from));
+			auto tm(Json::sorted_members(to));
+			if (!has_duplicates(fm) && !has_duplicates(tm)) {
+				merge(fm, tm);
+				return;
+			}
+			if (Json::equal(from, to)) {
+				return;
+			}
+		}
+
+		// members with duplicate keys can not be addressed
+		ops.resize(mark);
+		Json::Value value(to);
+		op("replace", &value);
+	}
+
+	void member_value(Json::Member const& member, Json::Value const& to)
+	{
+		// skip unchanged subtrees before building their path
+		if (Json::equal(member.value(), to)) {
+			return;
+		}
+
+		auto size(path_.size());
+		append_key(path_, member.key());
+		value(member.value(), to);
+		path_.resize(size);
+	}
+
+	void merge(std::vector<Json::Member const*> const& from,
+		std::vector<Json::Member const*> const& to)
+	{
+		auto size(path_.size());
+		size_t f(0);
+		size_t t(0);
+		while (f < from.size() || t < to.size()) {
+			int order(f == from.size() ? 1 : t == to.size() ? -1 :
+				Json::compare(from[f]->key(), to[t]->key()));
+			if (order < 0) {
+				append_key(path_, from[f++]->key());
+				op("remove", nullptr);
+			} else if (order > 0) {
+				append_key(path_, to[t]->key());
+				op("add", &to[t++]->value());
+			} else {
+				member_value(*from[f++], to[t++]->value());
+			}
+			path_.resize(size);
+		}
+	}
+
+	void array(Json::Array const& from, Json::Array const& to)
+	{
+		size_t head(0);
+		while (head < from.size() && head < to.size() &&
+		    Json::equal(from[head], to[head])) {
+			++head;
+		}
+
+		size_t tail(0);
+		while (tail < from.size() - head && tail < to.size() - head &&
+		    Json::equal(from[from.size() - 1 - tail], to[to.size() - 1 - tail])) {
+			++tail;
+		}
+
+		edit(from, to, head, align(from, to, head, tail));
+	}
+
+	/*
+	 * Edit script for the elements between head and tail from
+	 * the longest common subsequence of the elements, which are
+	 * compared by hash first.
+	 */
+	std::vector<Edit> align(Json::Array const& from, Json::Array const& to,
+		size_t head, size_t tail)
+	{
+		size_t fn(from.size() - head - tail);
+		size_t tn(to.size() - head - tail);
+		std::vector<Edit> res;
+
+		if (fn == 0 || tn == 0 || fn * tn == 1 || fn * tn > MAX_ALIGN) {
+			res.insert(res.end(), fn, REMOVE);
+			res.insert(res.end(), tn, ADD);
+			return res;
+		}
+
+		std::vector<uint64_t> fh(fn);
+		for (size_t i(0); i < fn; ++i) {
+			fh[i] = Json::hash(from[head + i]);
+		}
+		std::vector<uint64_t> th(tn);
+		for (size_t j(0); j < tn; ++j) {
+			th[j] = Json::hash(to[head + j]);
+		}
+
+		auto same([&](size_t i, size_t j) {
+			return fh[i] == th[j] && Json::equal(from[head + i], to[head + j]);
+		});
+
+		// common subsequence length of the suffixes at i, j
+		std::vector<uint32_t> lcs((fn + 1) * (tn + 1));
+		auto at([&](size_t i, size_t j) -> uint32_t & {
+			return lcs[i * (tn + 1) + j];
+		});
+		for (size_t i(fn); i-- > 0;) {
+			for (size_t j(tn); j-- > 0;) {
+				at(i, j) = same(i, j) ? at(i + 1, j + 1) + 1 :
+					std::max(at(i + 1, j), at(i, j + 1));
+			}
+		}
+
+		size_t i(0);
+		size_t j(0);
+		while (i < fn && j < tn) {
+			if (same(i, j)) {
+				res.push_back(KEEP);
+				++i;
+				++j;
+			} else if (at(i + 1, j) >= at(i, j + 1)) {
+				res.push_back(REMOVE);
+				++i;
+			} else {
+				res.push_back(ADD);
+				++j;
+			}
+		}
+		res.insert(res.end(), fn - i, REMOVE);
+		res.insert(res.end(), tn - j, ADD);
+		return res;
+	}
+
+	/*
+	 * Removed elements followed by added ones are diffed in
+	 * place pairwise, positions refer to the patched array.
+	 */
+	void edit(Json::Array const& from, Json::Array const& to,
+		size_t head, std::vector<Edit> const& script)
+	{
+		auto size(path_.size());
+		size_t pos(head);
+		size_t f(head);
+		size_t t(head);
+
+		for (size_t k(0); k < script.size();) {
+			if (script[k] == KEEP) {
+				++pos;
+				++f;
+				++t;
+				++k;
+				continue;
+			}
+
+			size_t removed(0);
+			size_t added(0);
+			for (; k < script.size() && script[k] != KEEP; ++k) {
+				++(script[k] == REMOVE ? removed : added);
+			}
+
+			for (auto pairs(std::min(removed, added)); pairs; --pairs) {
+				append_index(path_, pos++);
+				value(from[f++], to[t++]);
+				path_.resize(size);
+				--removed;
+				--added;
+			}
+			for (; removed; --removed) {
+				append_index(path_, pos);
+				op("remove", nullptr);
+				path_.resize(size);
+				++f;
+			}
+			for (; added; --added) {
+				append_index(path_, pos++);
+				op("add", &to[t++]);
+				path_.resize(size);
+			}
+		}
+	}
+
+	std::string path_;
+};
+
+Pointer parse_pointer(std::string const& path)
+{
+	Pointer res;
+	if (path.empty()) {
+		return res;
+	}
+
+	if (path[0] != '/') {
+		JSONCC_THROW(BAD_PATCH);
+	}
+
+	for (auto it(path.begin() + 1); ; ++it) {
+		res.emplace_back();
+		for (; it != path.end() && *it != '/'; ++it) {
+			if (*it != '~') {
+				res.back().push_back(*it);
+			} else if (++it != path.end() && (*it == '0' || *it == '1')) {
+				res.back().push_back(*it == '0' ? '~' : '/');
+			} else {
+				JSONCC_THROW(BAD_PATCH);
+			}
+		}
+		if (it == path.end()) {
+			return res;
+		}
+	}
+}
+
+/* array index of token, append allows "-" and size */
+size_t parse_index(std::string const& token, size_t size, bool append)
+{
+	if (append && token == "-") {
+		return size;
+	}
+
+	if (token.empty() || token.size() > 19 || (token.size() > 1 && token[0] == '0')) {
+		JSONCC_THROW(BAD_PATCH_PATH);
+	}
+
+	size_t res(0);
+	for (auto c: token) {
+		if (c < '0' || c > '9') {
+			JSONCC_THROW(BAD_PATCH_PATH);
+		}
+		res = res * 10 + (c - '0');
+	}
+
+	if (res > size || (res == size && !append)) {
+		JSONCC_THROW(BAD_PATCH_PATH);
+	}
+	return res;
+}
+
+/* value at the first count tokens of path */
+template <typename V>
+V & resolve(V & doc, Pointer const& path, size_t count)
+{
+	auto res(&doc);
+	for (size_t i(0); i < count; ++i) {
+		switch (res->tag()) {
+		case Json::Value::TAG_OBJECT:
+			res = res->object().find(path[i]);
+			if (!res) {
+				JSONCC_THROW(BAD_PATCH_PATH);
+			}
+			break;
+		case Json::Value::TAG_ARRAY: {
+			auto & array(res->array());
+			res = &array[parse_index(path[i], array.size(), false)];
+			break;
+		}
+		default:
+			JSONCC_THROW(BAD_PATCH_PATH);
+		}
+	}
+	return *res;
+}
+
+void add(Json::Value & doc, Pointer const& path, Json::Value value)
+{
+	if (path.empty()) {
+		doc = std::move(value);
+		return;
+	}
+
+	auto & parent(resolve(doc, path, path.size() - 1));
+	auto const& key(path.back());
+	switch (parent.tag()) {
+	case Json::Value::TAG_OBJECT: {
+		auto & object(parent.object());
+		auto member(object.find(key));
+		if (member) {
+			*member = std::move(value);
+		} else {
+			object << Json::Member(Json::String(key), std::move(value));
+		}
+		break;
+	}
+	case Json::Value::TAG_ARRAY: {
+		auto & array(parent.array());
+		array.insert(parse_index(key, array.size(), true), std::move(value));
+		break;
+	}
+	default:
+		JSONCC_THROW(BAD_PATCH_PATH);
+	}
+}
+
+Json::Value remove(Json::Value & doc, Pointer const& path)
+{
+	if (path.empty()) {
+		JSONCC_THROW(BAD_PATCH_PATH);
+	}
+
+	auto & parent(resolve(doc, path, path.size() - 1));
+	auto const& key(path.back());
+	switch (parent.tag()) {
+	case Json::Value::TAG_OBJECT: {
+		auto & object(parent.object());
+		auto member(object.find(key));
+		if (!member) {
+			JSONCC_THROW(BAD_PATCH_PATH);
+		}
+		Json::Value res(std::move(*member));
+		object.erase(key);
+		return res;
+	}
+	case Json::Value::TAG_ARRAY: {
+		auto & array(parent.array());
+		auto index(parse_index(key, array.size(), false));
+		Json::Value res(std::move(array[index]));
+		array.erase(index);
+		return res;
+	}
+	default:
+		JSONCC_THROW(BAD_PATCH_PATH);
+	}
+}
+
+Json::Value const& member(Json::Object const& op, char const* key)
+{
+	auto res(op.find(key));
+	if (!res) {
+		JSONCC_THROW(BAD_PATCH);
+	}
+	return *res;
+}
+
+std::string string_member(Json::Object const& op, char const* key)
+{
+	auto const& res(member(op, key));
+	if (res.tag() != Json::Value::TAG_STRING) {
+		JSONCC_THROW(BAD_PATCH);
+	}
+	return res.string().value();
+}
+
+void apply_op(Json::Value & doc, Json::Value const& value)
+{
+	if (value.tag() != Json::Value::TAG_OBJECT) {
+		JSONCC_THROW(BAD_PATCH);
+	}
+
+	auto const& op(value.object());
+	auto name(string_member(op, "op"));
+	auto path(parse_pointer(string_member(op, "path")));
+
+	if (name == "add") {
+		add(doc, path, member(op, "value"));
+	} else if (name == "remove") {
+		remove(doc, path);
+	} else if (name == "replace") {
+		resolve(doc, path, path.size()) = member(op, "value");
+	} else if (name == "move") {
+		auto from(parse_pointer(string_member(op, "from")));
+		if (from.size() < path.size() &&
+		    std::equal(from.begin(), from.end(), path.begin())) {
+			// into one of its own children
+			JSONCC_THROW(BAD_PATCH);
+		}
+		if (from != path) {
+			add(doc, path, remove(doc, from));
+		}
+	} else if (name == "copy") {
+		auto from(parse_pointer(string_member(op, "from")));
+		Json::Value const& cdoc(doc);
+		add(doc, path, resolve(cdoc, from, from.size()));
+	} else if (name == "test") {
+		Json::Value const& cdoc(doc);
+		if (!Json::equal(resolve(cdoc, path, path.size()), member(op, "value"))) {
+			JSONCC_THROW(PATCH_TEST_FAILED);
+		}
+	} else {
+		JSONCC_THROW(BAD_PATCH);
+	}
+}
+
+}
+
+namespace Json {
+
+Value diff(Value const& from, Value const& to)
+{
+	Diff diff;
+	diff.value(from, to);
+	return Value(Array(
+		std::make_move_iterator(diff.ops.begin()),
+		std::make_move_iterator(diff.ops.end())));
+}
+
+void apply(Value & doc, Value const& patch)
+{
+	if (patch.tag() != Value::TAG_ARRAY) {
+		JSONCC_THROW(BAD_PATCH);
+	}
+
+	for (auto const& op: patch.array()) {
+		apply_op(doc, op);
+	}
+}
+
+void apply(Value & doc, Value const& patch, Error & err)
+{
+	try {
+		apply(doc, patch);
+	} catch (Error & e) {
+		err = e;
+	}
+}
+
+void merge_patch(Value & target, Value const& patch)
+{
+	merge_patch(target, Value(patch));
+}
+
+void merge_patch(Value & target, Value && patch)
+{
+	if (patch.tag() != Value::TAG_OBJECT) {
+		target = std::move(patch);
+		return;
+	}
+
+	if (target.tag() != Value::TAG_OBJECT) {
+		target = Object();
+	}
+
+	auto & object(target.object());
+	for (auto & member: patch.object()) {
+		auto key(member.key().value());
+		auto & value(member.value());
+		if (value.tag() == Value::TAG_NULL) {
+			while (object.erase(key)) { }
+			continue;
+		}
+
+		auto existing(object.find(key));
+		if (existing) {
+			merge_patch(*existing, std::move(value));
+		} else {
+			// nulls in a new object are dropped as well
+			Value res;
+			merge_patch(res, std::move(value));
+			object << Member(String(std::move(key)), std::move(res));
+		}
+	}
+}
+
+}
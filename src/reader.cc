@@ -0,0 +1,493 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "parser-impl.h"
+
+#include "error.h"
+#include "token-stream.h"
+#include "utf8stream.h"
+
+namespace {
+
+// same limit as the parser
+const size_t MAX_DEPTH = 255;
+
+bool is_scalar(Json::Token::Type type)
+{
+	switch (type) {
+	case Json::Token::TRUE_LITERAL:    return true;
+	case Json::Token::FALSE_LITERAL:   return true;
+	case Json::Token::NULL_LITERAL:    return true;
+	case Json::Token::STRING:          return true;
+	case Json::Token::NUMBER:          return true;
+	case Json::Token::END:             return false;
+	case Json::Token::INVALID:         return false;
+	case Json::Token::BEGIN_ARRAY:     return false;
+	case Json::Token::BEGIN_OBJECT:    return false;
+	case Json::Token::END_ARRAY:       return false;
+	case Json::Token::END_OBJECT:      return false;
+	case Json::Token::NAME_SEPARATOR:  return false;
+	case Json::Token::VALUE_SEPARATOR: return false;
+	}
+	assert(false);                // LCOV_EXCL_LINE
+	JSONCC_THROW(INTERNAL_ERROR); // LCOV_EXCL_LINE
+}
+
+template <typename T>
+T read_signed(Json::Reader & reader)
+{
+	auto value(reader.int64());
+	if (value < int64_t(std::numeric_limits<T>::min()) ||
+	    value > int64_t(std::numeric_limits<T>::max())) {
+		JSONCC_THROW(BAD_READER_TYPE);
+	}
+	return T(value);
+}
+
+template <typename T>
+T read_unsigned(Json::Reader & reader)
+{
+	auto value(reader.uint64());
+	if (value > uint64_t(std::numeric_limits<T>::max())) {
+		JSONCC_THROW(BAD_READER_TYPE);
+	}
+	return T(value);
+}
+
+template <typename T>
+T read_float(Json::Reader & reader)
+{
+	auto value(reader.real());
+	T res(value);
+	if (std::isinf(res) && !std::isinf(value)) {
+		JSONCC_THROW(BAD_READER_TYPE);
+	}
+	return res;
+}
+
+}
+
+namespace Json {
+
+/*
+ * Token stream with one token lookahead and a stack of the
+ * open containers. The grammar is checked here the same way
+ * the parser state engines do, with the same error types.
+ */
+class ReaderImpl {
+public:
+	ReaderImpl(char const * data, size_t size)
+	:
+		stream_(data, size),
+		tokenizer_(stream_, TokenStream::STRING_REFERENCE),
+		pending_(false),
+		started_(false),
+		open_()
+	{ }
+
+	/* the next token, scanned on first access */
+	Token & token()
+	{
+		if (!pending_) {
+			tokenizer_.scan();
+			pending_ = true;
+		}
+		return tokenizer_.token;
+	}
+
+	void consume()
+	{
+		pending_ = false;
+	}
+
+	/* the next token, which has to start a value */
+	Token & value_token()
+	{
+		auto & tok(token());
+		if (open_.empty()) {
+			if (started_ || (tok.type != Token::BEGIN_ARRAY &&
+			    tok.type != Token::BEGIN_OBJECT)) {
+				JSONCC_THROW(BAD_TOKEN_DOCUMENT);
+			}
+		} else if (!is_scalar(tok.type) && tok.type != Token::BEGIN_ARRAY &&
+		    tok.type != Token::BEGIN_OBJECT) {
+			bad_value();
+		}
+		return tok;
+	}
+
+	Token & scalar(Token::Type type)
+	{
+		auto & tok(value_token());
+		if (tok.type != type) {
+			JSONCC_THROW(BAD_READER_TYPE);
+		}
+		consume();
+		return tok;
+	}
+
+	void begin(Token::Type type, bool object)
+	{
+		scalar(type);
+		if (open_.size() == MAX_DEPTH) {
+			JSONCC_THROW(PARSER_OVERFLOW);
+		}
+		started_ = true;
+		open_.push_back(Frame(object));
+	}
+
+	bool next_element()
+	{
+		assert(!open_.empty() && !open_.back().object);
+		auto & frame(open_.back());
+		auto & tok(token());
+		if (tok.type == Token::END_ARRAY) {
+			return close();
+		}
+
+		if (frame.count != 0) {
+			if (tok.type != Token::VALUE_SEPARATOR) {
+				JSONCC_THROW(BAD_TOKEN_ARRAY_VALUE);
+			}
+			consume();
+			// trailing separator, as accepted by the parser
+			if (token().type == Token::END_ARRAY) {
+				return close();
+			}
+		}
+
+		++frame.count;
+		return true;
+	}
+
+	bool next_member(std::string & key)
+	{
+		assert(!open_.empty() && open_.back().object);
+		auto & frame(open_.back());
+		auto tok(&token());
+		if (tok->type == Token::END_OBJECT) {
+			return close();
+		}
+
+		if (frame.count != 0) {
+			if (tok->type != Token::VALUE_SEPARATOR) {
+				JSONCC_THROW(BAD_TOKEN_OBJECT_VALUE);
+			}
+			consume();
+			tok = &token();
+		}
+
+		if (tok->type != Token::STRING) {
+			if (frame.count == 0) {
+				JSONCC_THROW(BAD_TOKEN_OBJECT_START);
+			}
+			JSONCC_THROW(BAD_TOKEN_OBJECT_NEXT);
+		}
+		string(*tok, key);
+		consume();
+
+		if (token().type != Token::NAME_SEPARATOR) {
+			JSONCC_THROW(BAD_TOKEN_OBJECT_NAME);
+		}
+		consume();
+
+		++frame.count;
+		return true;
+	}
+
+	void end()
+	{
+		if (!open_.empty() || token().type != Token::END) {
+			JSONCC_THROW(BAD_TOKEN_DOCUMENT);
+		}
+	}
+
+	static void string(Token & tok, std::string & res)
+	{
+		if (tok.str_ref) {
+			res.assign(tok.str_ref, tok.str_ref_size);
+		} else {
+			res.swap(tok.str_value);
+		}
+	}
+
+private:
+	struct Frame {
+		explicit Frame(bool object_)
+		: object(object_), count(0) { }
+
+		bool object;
+		size_t count;
+	};
+
+	bool close()
+	{
+		consume();
+		open_.pop_back();
+		return false;
+	}
+
+	void bad_value() const
+	{
+		auto const& frame(open_.back());
+		if (frame.object) {
+			JSONCC_THROW(BAD_TOKEN_OBJECT_SEP);
+		} else if (frame.count == 1) {
+			JSONCC_THROW(BAD_TOKEN_ARRAY_START);
+		}
+		JSONCC_THROW(BAD_TOKEN_ARRAY_NEXT);
+	}
+
+	Utf8Stream stream_;
+	TokenStream tokenizer_;
+	bool pending_;
+	bool started_;
+	std::vector<Frame> open_;
+};
+
+Reader::Reader(char const * data, size_t size)
+:
+	impl_(new ReaderImpl(data, size))
+{ }
+
+Reader::~Reader()
+{ }
+
+Value::Tag Reader::peek()
+{
+	switch (impl_->value_token().type) {
+	case Token::TRUE_LITERAL:    return Value::TAG_TRUE;
+	case Token::FALSE_LITERAL:   return Value::TAG_FALSE;
+	case Token::NULL_LITERAL:    return Value::TAG_NULL;
+	case Token::STRING:          return Value::TAG_STRING;
+	case Token::NUMBER:          return Value::TAG_NUMBER;
+	case Token::BEGIN_ARRAY:     return Value::TAG_ARRAY;
+	case Token::BEGIN_OBJECT:    return Value::TAG_OBJECT;
+	case Token::END:             assert(false); // LCOV_EXCL_LINE
+	case Token::INVALID:         assert(false); // LCOV_EXCL_LINE
+	case Token::END_ARRAY:       assert(false); // LCOV_EXCL_LINE
+	case Token::END_OBJECT:      assert(false); // LCOV_EXCL_LINE
+	case Token::NAME_SEPARATOR:  assert(false); // LCOV_EXCL_LINE
+	case Token::VALUE_SEPARATOR: assert(false); // LCOV_EXCL_LINE
+	}
+	JSONCC_THROW(INTERNAL_ERROR);               // LCOV_EXCL_LINE
+}
+
+void Reader::null()
+{
+	impl_->scalar(Token::NULL_LITERAL);
+}
+
+bool Reader::boolean()
+{
+	auto & tok(impl_->value_token());
+	if (tok.type != Token::TRUE_LITERAL && tok.type != Token::FALSE_LITERAL) {
+		JSONCC_THROW(BAD_READER_TYPE);
+	}
+	impl_->consume();
+	return tok.type == Token::TRUE_LITERAL;
+}
+
+int64_t Reader::int64()
+{
+	auto & tok(impl_->value_token());
+	if (tok.type != Token::NUMBER || tok.number_type != Token::INT) {
+		JSONCC_THROW(BAD_READER_TYPE);
+	}
+	impl_->consume();
+	return tok.int_value;
+}
+
+uint64_t Reader::uint64()
+{
+	auto & tok(impl_->value_token());
+	if (tok.type != Token::NUMBER || tok.number_type != Token::INT ||
+	    tok.int_value < 0) {
+		JSONCC_THROW(BAD_READER_TYPE);
+	}
+	impl_->consume();
+	return tok.int_value;
+}
+
+long double Reader::real()
+{
+	auto & tok(impl_->scalar(Token::NUMBER));
+	if (tok.number_type == Token::INT) {
+		return tok.int_value;
+	}
+	return tok.float_value;
+}
+
+std::string Reader::string()
+{
+	std::string res;
+	ReaderImpl::string(impl_->scalar(Token::STRING), res);
+	return res;
+}
+
+Value Reader::value()
+{
+	switch (peek()) {
+	case Value::TAG_ARRAY: {
+		Array res;
+		begin_array();
+		while (next_element()) {
+			res << value();
+		}
+		return Value(std::move(res));
+	}
+	case Value::TAG_OBJECT: {
+		Object res;
+		std::string key;
+		begin_object();
+		while (next_member(key)) {
+			res << Member(key, value());
+		}
+		return Value(std::move(res));
+	}
+	case Value::TAG_STRING:
+		return String(string());
+	case Value::TAG_NULL:
+	case Value::TAG_TRUE:
+	case Value::TAG_FALSE:
+	case Value::TAG_NUMBER: {
+		Value res(token_value(impl_->token()));
+		impl_->consume();
+		return res;
+	}
+	case Value::TAG_INVALID: assert(false); // LCOV_EXCL_LINE
+	}
+	JSONCC_THROW(INTERNAL_ERROR);           // LCOV_EXCL_LINE
+}
+
+void Reader::skip()
+{
+	switch (peek()) {
+	case Value::TAG_ARRAY:
+		begin_array();
+		while (next_element()) {
+			skip();
+		}
+		return;
+	case Value::TAG_OBJECT: {
+		std::string key;
+		begin_object();
+		while (next_member(key)) {
+			skip();
+		}
+		return;
+	}
+	case Value::TAG_NULL:
+	case Value::TAG_TRUE:
+	case Value::TAG_FALSE:
+	case Value::TAG_NUMBER:
+	case Value::TAG_STRING:
+		impl_->consume();
+		return;
+	case Value::TAG_INVALID: assert(false); // LCOV_EXCL_LINE
+	}
+	JSONCC_THROW(INTERNAL_ERROR);           // LCOV_EXCL_LINE
+}
+
+void Reader::begin_array()
+{
+	impl_->begin(Token::BEGIN_ARRAY, false);
+}
+
+bool Reader::next_element()
+{
+	return impl_->next_element();
+}
+
+void Reader::begin_object()
+{
+	impl_->begin(Token::BEGIN_OBJECT, true);
+}
+
+bool Reader::next_member(std::string & key)
+{
+	return impl_->next_member(key);
+}
+
+void Reader::end()
+{
+	impl_->end();
+}
+
+void ValueReader<bool>::read(Reader & reader, bool & res)
+{
+	res = reader.boolean();
+}
+
+void ValueReader<uint8_t>::read(Reader & reader, uint8_t & res)
+{
+	res = read_unsigned<uint8_t>(reader);
+}
+
+void ValueReader<int8_t>::read(Reader & reader, int8_t & res)
+{
+	res = read_signed<int8_t>(reader);
+}
+
+void ValueReader<uint16_t>::read(Reader & reader, uint16_t & res)
+{
+	res = read_unsigned<uint16_t>(reader);
+}
+
+void ValueReader<int16_t>::read(Reader & reader, int16_t & res)
+{
+	res = read_signed<int16_t>(reader);
+}
+
+void ValueReader<uint32_t>::read(Reader & reader, uint32_t & res)
+{
+	res = read_unsigned<uint32_t>(reader);
+}
+
+void ValueReader<int32_t>::read(Reader & reader, int32_t & res)
+{
+	res = read_signed<int32_t>(reader);
+}
+
+void ValueReader<uint64_t>::read(Reader & reader, uint64_t & res)
+{
+	res = reader.uint64();
+}
+
+void ValueReader<int64_t>::read(Reader & reader, int64_t & res)
+{
+	res = reader.int64();
+}
+
+void ValueReader<float>::read(Reader & reader, float & res)
+{
+	res = read_float<float>(reader);
+}
+
+void ValueReader<double>::read(Reader & reader, double & res)
+{
+	res = read_float<double>(reader);
+}
+
+void ValueReader<long double>::read(Reader & reader, long double & res)
+{
+	res = reader.real();
+}
+
+void ValueReader<std::string>::read(Reader & reader, std::string & res)
+{
+	res = reader.string();
+}
+
+void ValueReader<Value>::read(Reader & reader, Value & res)
+{
+	res = reader.value();
+}
+
+}
@@ -0,0 +1,157 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cstdint>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "serializer.h"
+
+namespace {
+
+bool needs_escape(unsigned char c)
+{
+	return c < 0x20 || c == '"' || c == '\\';
+}
+
+#ifdef __SSE2__
+/* offset of the first byte to escape in 16 bytes at data, 16 for none */
+unsigned scan16(char const *data)
+{
+	const __m128i ctrl(_mm_set1_epi8(0x1f));
+	const __m128i quote(_mm_set1_epi8('"'));
+	const __m128i backslash(_mm_set1_epi8('\\'));
+
+	__m128i v(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)));
+	__m128i hits(_mm_cmpeq_epi8(_mm_min_epu8(v, ctrl), v));
+	hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, quote));
+	hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, backslash));
+
+	unsigned mask(_mm_movemask_epi8(hits));
+	return mask ? __builtin_ctz(mask) : 16;
+}
+#else
+/* true if any of the 8 bytes at data may need escaping */
+bool scan8(char const *data)
+{
+	const uint64_t ones(0x0101010101010101ULL);
+	const uint64_t highs(0x8080808080808080ULL);
+
+	uint64_t v;
+	memcpy(&v, data, sizeof(v));
+	uint64_t q(v ^ (ones * '"'));
+	uint64_t b(v ^ (ones * '\\'));
+	uint64_t hits((v - ones * 0x20) | (q - ones) | (b - ones));
+	return (hits & ~v & highs) != 0;
+}
+#endif
+
+}
+
+namespace Json {
+
+size_t escape_scan(char const *data, size_t size)
+{
+	size_t pos(0);
+#ifdef __SSE2__
+	for (; pos + 16 <= size; pos += 16) {
+		auto offs(scan16(data + pos));
+		if (offs != 16) {
+			return pos + offs;
+		}
+	}
+#else
+	for (; pos + 8 <= size && !scan8(data + pos); pos += 8) {
+	}
+#endif
+	for (; pos < size; ++pos) {
+		if (needs_escape(data[pos])) {
+			break;
+		}
+	}
+	return pos;
+}
+
+char const* escape_sequence(unsigned char c)
+{
+/*
+   All Unicode characters may be placed within the quotation marks,
+   except for the characters that must be escaped: quotation mark,
+   reverse solidus, and the control characters (U+0000 through U+001F).
+*/
+	static char const* const ctrl[0x20] = {
+		"\\u0000", "\\u0001", "\\u0002", "\\u0003",
+		"\\u0004", "\\u0005", "\\u0006", "\\u0007",
+		"\\b",     "\\t",     "\\n",     "\\u000b",
+		"\\f",     "\\r",     "\\u000e", "\\u000f",
+		"\\u0010", "\\u0011", "\\u0012", "\\u0013",
+		"\\u0014", "\\u0015", "\\u0016", "\\u0017",
+		"\\u0018", "\\u0019", "\\u001a", "\\u001b",
+		"\\u001c", "\\u001d", "\\u001e", "\\u001f",
+	};
+
+	if (c < 0x20) {
+		return ctrl[c];
+	} else if (c == '"') {
+		return "\\\"";
+	} else if (c == '\\') {
+		return "\\\\";
+	}
+	return nullptr;
+}
+
+}
+
+namespace {
+
+/* next code point of a UTF-8 string, bytes of bad sequences as is */
+uint32_t next_code_point(unsigned char const *& p, unsigned char const *end)
+{
+	uint32_t c(*p++);
+	int follow(c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : c >= 0xc0 ? 1 : 0);
+	if (follow == 0 || end - p < follow) {
+		return c;
+	}
+
+	c &= 0x3f >> follow;
+	for (int i(0); i < follow; ++i) {
+		c = (c << 6) | (*p++ & 0x3f);
+	}
+	return c;
+}
+
+/* leading UTF-16 code unit, a high surrogate beyond the BMP */
+uint32_t first_unit(uint32_t c)
+{
+	return c >= 0x10000 ? 0xd800 + ((c - 0x10000) >> 10) : c;
+}
+
+}
+
+namespace Json {
+
+bool canonical_less(String const& l, String const& r)
+{
+	auto lp(reinterpret_cast<unsigned char const *>(l.data()));
+	auto rp(reinterpret_cast<unsigned char const *>(r.data()));
+	auto lend(lp + l.size());
+	auto rend(rp + r.size());
+
+	while (lp != lend && rp != rend) {
+		auto lc(next_code_point(lp, lend));
+		auto rc(next_code_point(rp, rend));
+		if (lc != rc) {
+			auto lu(first_unit(lc));
+			auto ru(first_unit(rc));
+			// same high surrogate orders like the code points
+			return lu != ru ? lu < ru : lc < rc;
+		}
+	}
+	return lp == lend && rp != rend;
+}
+
+}
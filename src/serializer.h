@@ -0,0 +1,300 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#ifndef JSONCC_SERIALIZER_H
+#define JSONCC_SERIALIZER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <jsoncc.h>
+#include "error.h"
+#include "dtoa.h"
+#include "itoa.h"
+
+namespace Json {
+
+/*
+ * Escape sequence for characters the rfc requires to be
+ * escaped in strings: quotation mark, reverse solidus and
+ * the control characters, nullptr for any other.
+ */
+char const* escape_sequence(unsigned char);
+
+/*
+ * Offset of the first character in data that needs escaping,
+ * size if there is none. Checks 16 bytes at a time with SSE2,
+ * 8 bytes at a time otherwise.
+ */
+size_t escape_scan(char const *, size_t);
+
+/*
+ * Order of member keys in canonical output: by UTF-16 code
+ * units of the UTF-8 encoded keys (RFC 8785 3.2.3).
+ */
+bool canonical_less(String const&, String const&);
+
+/*
+ * Formats values in the layout of the operator<< overloads,
+ * or canonical as of RFC 8785 with STYLE_CANONICAL.
+ *
+ * Out receives the output through
+ *   void append(char const *, size_t);
+ *   void put(char);
+ *   void reference(char const *, size_t);
+ * where reference() is used for string runs that remain
+ * valid until the value is serialized.
+ */
+template <typename Out>
+class Serializer {
+public:
+	Serializer(Out & out, Writer::Style style,
+		char indent_char = '\t', size_t indent_width = 1)
+	:
+		out_(out),
+		style_(style),
+		depth_(0),
+		indent_width_(indent_width),
+		newline_(1, '\n')
+	{
+		newline_.append(8 * indent_width_, indent_char);
+	}
+
+	void value(Value const& value)
+	{
+		switch (value.tag()) {
+		case Value::TAG_INVALID:
+			assert(false);
+			break;
+		case Value::TAG_TRUE:   literal("true");         break;
+		case Value::TAG_FALSE:  literal("false");        break;
+		case Value::TAG_NULL:   literal("null");         break;
+		case Value::TAG_NUMBER: number(value.number());  break;
+		case Value::TAG_STRING: string(value.string());  break;
+		case Value::TAG_OBJECT: object(value.object());  break;
+		case Value::TAG_ARRAY:  array(value.array());    break;
+		}
+	}
+
+	void number(Number const& number)
+	{
+		if (style_ == Writer::STYLE_CANONICAL) {
+			canonical_number(number);
+			return;
+		}
+
+		char buf[DTOA_BUFSIZE];
+		size_t len(0);
+		switch (number.type()) {
+		case Number::TYPE_INVALID:
+			assert(false);
+			break;
+		case Number::TYPE_INT:
+			len = i64toa(number.int_value(), buf);
+			break;
+		case Number::TYPE_UINT:
+			len = u64toa(number.uint_value(), buf);
+			break;
+		case Number::TYPE_FP:
+			if (!std::isfinite(number.fp_value())) {
+				// no nan or inf in JSON, as JSON.stringify()
+				literal("null");
+				return;
+			}
+			len = ldtoa(number.fp_value(), buf);
+			break;
+		}
+		out_.append(buf, len);
+	}
+
+	/* compact arrays, without creating Values */
+	template <typename T>
+	void numbers(std::vector<T> const& numbers)
+	{
+		begin('[');
+		auto first(true);
+		for (auto element: numbers) {
+			separator(first);
+			number(Number(element));
+		}
+		end(']', first);
+	}
+
+	void literal(char const* lit)
+	{
+		out_.append(lit, strlen(lit));
+	}
+
+	void string(String const& string)
+	{
+		quote(string.data(), string.size());
+	}
+
+	void array(Array const& array)
+	{
+		switch (array.storage()) {
+		case Array::STORAGE_VALUES: break;
+		case Array::STORAGE_INT:    numbers(array.int_values());  return;
+		case Array::STORAGE_UINT:   numbers(array.uint_values()); return;
+		case Array::STORAGE_FP:     numbers(array.fp_values());   return;
+		}
+
+		begin('[');
+		auto first(true);
+		for (auto const& element: array) {
+			separator(first);
+			value(element);
+		}
+		end(']', first);
+	}
+
+	void object(Object const& object)
+	{
+		if (style_ == Writer::STYLE_CANONICAL) {
+			canonical_object(object);
+			return;
+		}
+
+		begin('{');
+		auto first(true);
+		for (auto const& member: object) {
+			separator(first);
+			key(member.key());
+			value(member.value());
+		}
+		end('}', first);
+	}
+
+	/*
+	 * Container layout, members are written as key() followed
+	 * by their value. An empty container is closed right away.
+	 */
+	void begin(char delim)
+	{
+		out_.put(delim);
+		++depth_;
+	}
+
+	void separator(bool & first)
+	{
+		if (first) {
+			first = false;
+			if (style_ == Writer::STYLE_INDENT) {
+				newline();
+			}
+		} else if (style_ == Writer::STYLE_INDENT) {
+			out_.put(',');
+			newline();
+		} else if (style_ == Writer::STYLE_NOINDENT) {
+			out_.append(", ", 2);
+		} else {
+			out_.put(',');
+		}
+	}
+
+	void key(String const& key)
+	{
+		string(key);
+		if (style_ == Writer::STYLE_CANONICAL) {
+			out_.put(':');
+		} else {
+			out_.append(": ", 2);
+		}
+	}
+
+	void end(char delim, bool empty)
+	{
+		--depth_;
+		if (!empty && style_ == Writer::STYLE_INDENT) {
+			newline();
+		}
+		out_.put(delim);
+	}
+
+private:
+	/* all numbers are IEEE doubles in RFC 8785 */
+	void canonical_number(Number const& number)
+	{
+		double value(0.0);
+		switch (number.type()) {
+		case Number::TYPE_INVALID:
+			assert(false);
+			break;
+		case Number::TYPE_INT:  value = number.int_value();  break;
+		case Number::TYPE_UINT: value = number.uint_value(); break;
+		case Number::TYPE_FP:   value = number.fp_value();   break;
+		}
+
+		if (!std::isfinite(value)) {
+			JSONCC_THROW(BAD_CANONICAL_NUMBER);
+		}
+
+		char buf[DTOA_BUFSIZE];
+		out_.append(buf, dtoa_es(value, buf));
+	}
+
+	void canonical_object(Object const& object)
+	{
+		std::vector<Member const*> members;
+		members.reserve(object.size());
+		for (auto const& member: object) {
+			members.push_back(&member);
+		}
+		std::stable_sort(members.begin(), members.end(),
+			[](Member const* l, Member const* r) {
+				return canonical_less(l->key(), r->key());
+			});
+
+		begin('{');
+		auto first(true);
+		for (auto member: members) {
+			separator(first);
+			key(member->key());
+			value(member->value());
+		}
+		end('}', first);
+	}
+
+	void quote(char const* data, size_t size)
+	{
+		out_.put('"');
+		for (;;) {
+			auto run(escape_scan(data, size));
+			out_.reference(data, run);
+			if (run == size) {
+				break;
+			}
+
+			auto esc(escape_sequence(data[run]));
+			out_.append(esc, strlen(esc));
+			data += run + 1;
+			size -= run + 1;
+		}
+		out_.put('"');
+	}
+
+	/* newline_ holds a newline and the indentation of several levels */
+	void newline()
+	{
+		auto len(1 + depth_ * indent_width_);
+		while (len > newline_.size()) {
+			newline_.append(newline_.size() - 1, newline_.back());
+		}
+		out_.append(newline_.data(), len);
+	}
+
+	Out & out_;
+	Writer::Style style_;
+	size_t depth_;
+	size_t indent_width_;
+	std::string newline_;
+};
+
+}
+
+#endif
@@ -9,48 +9,92 @@ namespace Json {
 
 String::String()
 :
-	value_()
+	value_(),
+	ref_(nullptr),
+	ref_size_(0)
 { }
 
 String::String(String const& o)
 :
-	value_(o.value_)
+	value_(o.value_),
+	ref_(o.ref_),
+	ref_size_(o.ref_size_)
 { }
 
-String::String(String && o)
+String::String(String && o) noexcept
 :
-	value_(std::move(o.value_))
+	value_(std::move(o.value_)),
+	ref_(o.ref_),
+	ref_size_(o.ref_size_)
 { }
 
 String::String(std::string const& value)
 :
-	value_(value)
+	value_(value),
+	ref_(nullptr),
+	ref_size_(0)
+{ }
+
+String::String(std::string && value)
+:
+	value_(std::move(value)),
+	ref_(nullptr),
+	ref_size_(0)
 { }
 
 String::String(const char *value)
 :
-	value_(value)
+	value_(value),
+	ref_(nullptr),
+	ref_size_(0)
 { }
 
+String String::reference(const char *data, size_t size)
+{
+	String res;
+	res.ref_ = data;
+	res.ref_size_ = size;
+	return res;
+}
+
 String & String::operator=(String const& o)
 {
 	if (&o != this) {
 		value_ = o.value_;
+		ref_ = o.ref_;
+		ref_size_ = o.ref_size_;
 	}
 	return *this;
 }
 
-String & String::operator=(String && o)
+String & String::operator=(String && o) noexcept
 {
 	if (&o != this) {
 		value_ = std::move(o.value_);
+		ref_ = o.ref_;
+		ref_size_ = o.ref_size_;
 	}
 	return *this;
 }
 
 std::string String::value() const
 {
-	return value_;
+	return ref_ ? std::string(ref_, ref_size_) : value_;
+}
+
+bool String::is_reference() const
+{
+	return ref_ != nullptr;
+}
+
+const char *String::data() const
+{
+	return ref_ ? ref_ : value_.data();
+}
+
+size_t String::size() const
+{
+	return ref_ ? ref_size_ : value_.size();
 }
 
 }
@@ -0,0 +1,447 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cassert>
+#include <cstring>
+#include <stack>
+
+#include "parser-impl.h"
+
+#include "error.h"
+#include "token-stream.h"
+
+namespace {
+
+enum TapeTag {
+	TAPE_NULL         = 'n',
+	TAPE_TRUE         = 't',
+	TAPE_FALSE        = 'f',
+	TAPE_INT          = 'l',
+	TAPE_FLOAT        = 'd',
+	TAPE_STRING       = '"',
+	TAPE_BEGIN_ARRAY  = '[',
+	TAPE_END_ARRAY    = ']',
+	TAPE_BEGIN_OBJECT = '{',
+	TAPE_END_OBJECT   = '}',
+};
+
+const uint64_t PAYLOAD_MASK = (uint64_t(1) << 56) - 1;
+
+uint64_t make_word(TapeTag tag, uint64_t payload = 0)
+{
+	assert(payload <= PAYLOAD_MASK);
+	return (uint64_t(tag) << 56) | payload;
+}
+
+TapeTag word_tag(uint64_t word)
+{
+	return TapeTag(word >> 56);
+}
+
+uint64_t word_payload(uint64_t word)
+{
+	return word & PAYLOAD_MASK;
+}
+
+}
+
+namespace Json {
+
+/* Parser handler appending to a Tape */
+class TapeBuilder : public ParserHandler {
+public:
+	TapeBuilder(Tape & tape, size_t size)
+	:
+		tape_(tape),
+		open_()
+	{
+		tape_.words_.reserve(size / 4 + 16);
+		tape_.strings_.reserve(size / 2 + 16);
+	}
+
+	void value(Token const& token)
+	{
+		switch (token.type) {
+		case Token::TRUE_LITERAL:  append(make_word(TAPE_TRUE));  break;
+		case Token::FALSE_LITERAL: append(make_word(TAPE_FALSE)); break;
+		case Token::NULL_LITERAL:  append(make_word(TAPE_NULL));  break;
+		case Token::STRING:        string(token);                 break;
+		case Token::NUMBER:
+			if (token.number_type == Token::FLOAT) {
+				double value(token.float_value);
+				uint64_t bits;
+				memcpy(&bits, &value, sizeof(bits));
+				append(make_word(TAPE_FLOAT));
+				append(bits);
+			} else {
+				append(make_word(TAPE_INT));
+				append(uint64_t(token.int_value));
+			}
+			break;
+		case Token::END:             assert(false); // LCOV_EXCL_LINE
+		case Token::INVALID:         assert(false); // LCOV_EXCL_LINE
+		case Token::BEGIN_ARRAY:     assert(false); // LCOV_EXCL_LINE
+		case Token::BEGIN_OBJECT:    assert(false); // LCOV_EXCL_LINE
+		case Token::END_ARRAY:       assert(false); // LCOV_EXCL_LINE
+		case Token::END_OBJECT:      assert(false); // LCOV_EXCL_LINE
+		case Token::NAME_SEPARATOR:  assert(false); // LCOV_EXCL_LINE
+		case Token::VALUE_SEPARATOR: assert(false); // LCOV_EXCL_LINE
+			JSONCC_THROW(INTERNAL_ERROR);       // LCOV_EXCL_LINE
+		}
+		count();
+	}
+
+	void begin_array()
+	{
+		begin(TAPE_BEGIN_ARRAY);
+	}
+
+	void end_array()
+	{
+		end(TAPE_END_ARRAY);
+	}
+
+	void begin_object()
+	{
+		begin(TAPE_BEGIN_OBJECT);
+	}
+
+	void key(Token const& token)
+	{
+		string(token);
+	}
+
+	void end_object()
+	{
+		end(TAPE_END_OBJECT);
+	}
+
+private:
+	struct Open {
+		size_t index;
+		size_t count;
+	};
+
+	void append(uint64_t word)
+	{
+		tape_.words_.push_back(word);
+	}
+
+	void string(Token const& token)
+	{
+		uint64_t size(token.str_value.size());
+		append(make_word(TAPE_STRING, tape_.strings_.size()));
+		tape_.strings_.append(reinterpret_cast<char const*>(&size), sizeof(size));
+		tape_.strings_.append(token.str_value);
+	}
+
+	void begin(TapeTag tag)
+	{
+		open_.push(Open{tape_.words_.size(), 0});
+		append(make_word(tag));
+	}
+
+	void end(TapeTag tag)
+	{
+		assert(!open_.empty());
+		auto open(open_.top());
+		open_.pop();
+		append(make_word(tag, open.count));
+		tape_.words_[open.index] |= tape_.words_.size();
+		count();
+	}
+
+	void count()
+	{
+		if (!open_.empty()) {
+			++open_.top().count;
+		}
+	}
+
+	Tape & tape_;
+	std::stack<Open> open_;
+};
+
+Tape::Tape()
+:
+	words_(),
+	strings_()
+{ }
+
+Tape::Tape(char const *data, size_t size)
+:
+	words_(),
+	strings_()
+{
+	TapeBuilder builder(*this, size);
+	ParserImpl().parse(data, size, builder);
+}
+
+TapeValue Tape::root() const
+{
+	return words_.empty() ? TapeValue() : TapeValue(this, 0);
+}
+
+TapeValue::TapeValue()
+:
+	tape_(nullptr),
+	index_(0)
+{ }
+
+TapeValue::TapeValue(Tape const* tape, size_t index)
+:
+	tape_(tape),
+	index_(index)
+{ }
+
+uint64_t TapeValue::word(size_t index) const
+{
+	assert(tape_ && index < tape_->words_.size());
+	return tape_->words_[index];
+}
+
+size_t TapeValue::next() const
+{
+	auto w(word(index_));
+	switch (word_tag(w)) {
+	case TAPE_INT:
+	case TAPE_FLOAT:
+		return index_ + 2;
+	case TAPE_BEGIN_ARRAY:
+	case TAPE_BEGIN_OBJECT:
+		return word_payload(w);
+	case TAPE_NULL:
+	case TAPE_TRUE:
+	case TAPE_FALSE:
+	case TAPE_STRING:
+	case TAPE_END_ARRAY:
+	case TAPE_END_OBJECT:
+		break;
+	}
+	return index_ + 1;
+}
+
+Value::Tag TapeValue::tag() const
+{
+	if (!tape_) {
+		return Value::TAG_INVALID;
+	}
+
+	switch (word_tag(word(index_))) {
+	case TAPE_NULL:         return Value::TAG_NULL;
+	case TAPE_TRUE:         return Value::TAG_TRUE;
+	case TAPE_FALSE:        return Value::TAG_FALSE;
+	case TAPE_INT:          return Value::TAG_NUMBER;
+	case TAPE_FLOAT:        return Value::TAG_NUMBER;
+	case TAPE_STRING:       return Value::TAG_STRING;
+	case TAPE_BEGIN_ARRAY:  return Value::TAG_ARRAY;
+	case TAPE_BEGIN_OBJECT: return Value::TAG_OBJECT;
+	case TAPE_END_ARRAY:    assert(false); // LCOV_EXCL_LINE
+	case TAPE_END_OBJECT:   assert(false); // LCOV_EXCL_LINE
+	}
+	return Value::TAG_INVALID;             // LCOV_EXCL_LINE
+}
+
+Number TapeValue::number() const
+{
+	assert(tag() == Value::TAG_NUMBER);
+	auto bits(word(index_ + 1));
+	if (word_tag(word(index_)) == TAPE_INT) {
+		return Number(int64_t(bits));
+	}
+
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return Number(value);
+}
+
+String TapeValue::string() const
+{
+	return String(std::string(string_data(), string_size()));
+}
+
+char const* TapeValue::string_data() const
+{
+	assert(word_tag(word(index_)) == TAPE_STRING);
+	return tape_->strings_.data() + word_payload(word(index_)) + sizeof(uint64_t);
+}
+
+size_t TapeValue::string_size() const
+{
+	assert(word_tag(word(index_)) == TAPE_STRING);
+	uint64_t size;
+	memcpy(&size, tape_->strings_.data() + word_payload(word(index_)), sizeof(size));
+	return size;
+}
+
+TapeObject TapeValue::object() const
+{
+	assert(tag() == Value::TAG_OBJECT);
+	return TapeObject(*this);
+}
+
+TapeArray TapeValue::array() const
+{
+	assert(tag() == Value::TAG_ARRAY);
+	return TapeArray(*this);
+}
+
+Value TapeValue::value() const
+{
+	switch (tag()) {
+	case Value::TAG_INVALID: return Value();
+	case Value::TAG_NULL:    return Null();
+	case Value::TAG_TRUE:    return True();
+	case Value::TAG_FALSE:   return False();
+	case Value::TAG_NUMBER:  return number();
+	case Value::TAG_STRING:  return string();
+	case Value::TAG_ARRAY: {
+		Array res;
+		for (auto element: array()) {
+			res << element.value();
+		}
+		return Value(std::move(res));
+	}
+	case Value::TAG_OBJECT: {
+		Object res;
+		for (auto member: object()) {
+			res << Member(member.key(), member.value().value());
+		}
+		return Value(std::move(res));
+	}
+	}
+	return Value();                        // LCOV_EXCL_LINE
+}
+
+TapeMember::TapeMember(TapeValue const& key)
+:
+	key_(key)
+{ }
+
+String TapeMember::key() const
+{
+	return key_.string();
+}
+
+TapeValue TapeMember::value() const
+{
+	return TapeValue(key_.tape_, key_.index_ + 1);
+}
+
+TapeObject::const_iterator::const_iterator(TapeValue const& key)
+:
+	key_(key)
+{ }
+
+TapeMember TapeObject::const_iterator::operator*() const
+{
+	return TapeMember(key_);
+}
+
+TapeObject::const_iterator & TapeObject::const_iterator::operator++()
+{
+	key_.index_ = TapeValue(key_.tape_, key_.index_ + 1).next();
+	return *this;
+}
+
+bool TapeObject::const_iterator::operator==(const_iterator const& o) const
+{
+	return key_.tape_ == o.key_.tape_ && key_.index_ == o.key_.index_;
+}
+
+bool TapeObject::const_iterator::operator!=(const_iterator const& o) const
+{
+	return !(*this == o);
+}
+
+TapeObject::TapeObject(TapeValue const& value)
+:
+	value_(value)
+{ }
+
+size_t TapeObject::size() const
+{
+	return word_payload(value_.word(value_.next() - 1));
+}
+
+TapeValue TapeObject::member(std::string const& key) const
+{
+	for (auto it(begin()); it != end(); ++it) {
+		auto const& k(it.key_);
+		if (k.string_size() == key.size() &&
+		    memcmp(k.string_data(), key.data(), key.size()) == 0) {
+			return (*it).value();
+		}
+	}
+	return TapeValue();
+}
+
+TapeObject::const_iterator TapeObject::begin() const
+{
+	return const_iterator(TapeValue(value_.tape_, value_.index_ + 1));
+}
+
+TapeObject::const_iterator TapeObject::end() const
+{
+	return const_iterator(TapeValue(value_.tape_, value_.next() - 1));
+}
+
+TapeArray::const_iterator::const_iterator(TapeValue const& value)
+:
+	value_(value)
+{ }
+
+TapeValue TapeArray::const_iterator::operator*() const
+{
+	return value_;
+}
+
+TapeArray::const_iterator & TapeArray::const_iterator::operator++()
+{
+	value_.index_ = value_.next();
+	return *this;
+}
+
+bool TapeArray::const_iterator::operator==(const_iterator const& o) const
+{
+	return value_.tape_ == o.value_.tape_ && value_.index_ == o.value_.index_;
+}
+
+bool TapeArray::const_iterator::operator!=(const_iterator const& o) const
+{
+	return !(*this == o);
+}
+
+TapeArray::TapeArray(TapeValue const& value)
+:
+	value_(value)
+{ }
+
+size_t TapeArray::size() const
+{
+	return word_payload(value_.word(value_.next() - 1));
+}
+
+TapeValue TapeArray::element(size_t index) const
+{
+	assert(index < size());
+	auto it(begin());
+	while (index--) {
+		++it;
+	}
+	return *it;
+}
+
+TapeArray::const_iterator TapeArray::begin() const
+{
+	return const_iterator(TapeValue(value_.tape_, value_.index_ + 1));
+}
+
+TapeArray::const_iterator TapeArray::end() const
+{
+	return const_iterator(TapeValue(value_.tape_, value_.next() - 1));
+}
+
+}
@@ -6,9 +6,11 @@
 
 #include <errno.h>
 
+#include <cassert>
 #include <cstdlib>
 #include <cstring>
 
+#include "auto-locale.h"
 #include "error.h"
 #include "token-stream.h"
 #include "utf8stream.h"
@@ -31,31 +33,11 @@ uint64_t make_int(const char *str)
 	return res;
 }
 
-// POSIX thread local locale setting.
-class AutoLocale {
-public:
-	AutoLocale(const char *name)
-	:
-		locale_(newlocale(LC_ALL_MASK, name, 0)),
-		saved_(uselocale(locale_))
-	{ }
-
-	~AutoLocale()
-	{
-		uselocale(saved_);
-		freelocale(locale_);
-	}
-
-private:
-	locale_t locale_;
-	locale_t saved_;
-};
-
 long double make_float(const char *str)
 {
 	errno = 0;
 	char *endp(0);
-	AutoLocale lc("C");
+	Json::AutoLocale lc("C");
 	auto res(strtold(str, &endp));
 	if (*endp != '\0' || errno != 0) {
 		JSONCC_THROW(NUMBER_INVALID);
@@ -159,7 +141,30 @@ enum StringState {
 	SDONES,
 };
 
-StringState scan_regular(int c, std::string & str)
+/* Output for decoding a string over its own source bytes */
+class InsituString {
+public:
+	explicit InsituString(char *pos)
+	:
+		pos_(pos)
+	{ }
+
+	void push_back(char c)
+	{
+		*pos_++ = c;
+	}
+
+	char *end() const
+	{
+		return pos_;
+	}
+
+private:
+	char *pos_;
+};
+
+template <typename Out>
+StringState scan_regular(int c, Out & str)
 {
 	if (c == '"') {
 		return SDONES;
@@ -173,7 +178,8 @@ StringState scan_regular(int c, std::string & str)
 	return SREGULAR;
 }
 
-StringState scan_escaped(int c, std::string & str)
+template <typename Out>
+StringState scan_escaped(int c, Out & str)
 {
 	switch (c) {
 	case '\\': case '/': case '"': break;
@@ -191,6 +197,32 @@ StringState scan_escaped(int c, std::string & str)
 	return SREGULAR;
 }
 
+/*
+ * Scan a string up to the closing quote, referencing it in
+ * the source. Stop after the backslash of the first escape
+ * sequence, the caller decodes the rest.
+ */
+StringState scan_reference(Json::Utf8Stream & stream, Json::Token & token)
+{
+	auto start(stream.cursor());
+	for (;;) {
+		auto c(stream.getc());
+		if (stream.state() != Json::Utf8Stream::SGOOD) {
+			JSONCC_THROW(STRING_QUOTE);
+		}
+
+		if (c == '"') {
+			token.str_ref = start;
+			token.str_ref_size = stream.cursor() - start - 1;
+			return SDONES;
+		} else if (c == '\\') {
+			return SESCAPED;
+		} else if (c >= 0x0000 && c <= 0x001F) {
+			JSONCC_THROW(STRING_CTRL);
+		}
+	}
+}
+
 struct UEscape {
 public:
 	UEscape()
@@ -199,7 +231,8 @@ public:
 		value_(0)
 	{ }
 
-	StringState scan(int c, std::string & str)
+	template <typename Out>
+	StringState scan(int c, Out & str)
 	{
 		value_ *= 0x10;
 		if (c >= '0' && c <= '9') {
@@ -222,7 +255,8 @@ public:
 	}
 
 private:
-	StringState utf8encode(std::string & str) const
+	template <typename Out>
+	StringState utf8encode(Out & str) const
 	{
 		if (value_ == 0x0000) {
 			JSONCC_THROW(UESCAPE_ZERO);
@@ -246,13 +280,51 @@ private:
 	uint16_t value_;
 };
 
+/* Decode the rest of a string starting in state into str */
+template <typename Out>
+void scan_decode(Json::Utf8Stream & stream, StringState state, Out & str)
+{
+	UEscape unicode;
+	while (state != SDONES) {
+		auto c(stream.getc());
+		if (stream.state() != Json::Utf8Stream::SGOOD) {
+			JSONCC_THROW(STRING_QUOTE);
+		}
+
+		switch (state) {
+		case SREGULAR:
+			state = scan_regular(c, str);
+			break;
+		case SESCAPED:
+			state = scan_escaped(c, str);
+			break;
+		case SUESCAPE:
+			state = unicode.scan(c, str);
+			break;
+		case SDONES:
+			break;
+		}
+	}
+}
+
 }
 
 namespace Json {
 
-TokenStream::TokenStream(Utf8Stream & stream)
+TokenStream::TokenStream(Utf8Stream & stream, StringMode string_mode)
+:
+	stream_(stream),
+	string_mode_(string_mode),
+	buffer_(nullptr)
+{
+	assert(string_mode_ != STRING_INSITU);
+}
+
+TokenStream::TokenStream(Utf8Stream & stream, char *buffer)
 :
-	stream_(stream)
+	stream_(stream),
+	string_mode_(STRING_INSITU),
+	buffer_(buffer)
 { }
 
 void TokenStream::scan()
@@ -335,28 +407,32 @@ void TokenStream::scan_literal(const char *literal)
 
 void TokenStream::scan_string()
 {
+	auto start(stream_.cursor());
 	auto state(SREGULAR);
-	UEscape unicode;
-	while (state != SDONES) {
-		auto c(stream_.getc());
-		if (stream_.state() != Utf8Stream::SGOOD) {
-			JSONCC_THROW(STRING_QUOTE);
-		}
+	if (string_mode_ == STRING_COPY) {
+		scan_decode(stream_, state, token.str_value);
+		return;
+	}
 
-		switch (state) {
-		case SREGULAR:
-			state = scan_regular(c, token.str_value);
-			break;
-		case SESCAPED:
-			state = scan_escaped(c, token.str_value);
-			break;
-		case SUESCAPE:
-			state = unicode.scan(c, token.str_value);
-			break;
-		case SDONES:
-			break;
-		}
+	state = scan_reference(stream_, token);
+	if (state == SDONES) {
+		return;
 	}
+
+	// prefix up to the backslash is already in place
+	auto prefix(stream_.cursor() - start - 1);
+	if (string_mode_ == STRING_REFERENCE) {
+		token.str_value.assign(start, prefix);
+		scan_decode(stream_, state, token.str_value);
+		return;
+	}
+
+	// decoded output never outruns the read cursor
+	auto begin(buffer_ + (start - buffer_));
+	InsituString out(begin + prefix);
+	scan_decode(stream_, state, out);
+	token.str_ref = begin;
+	token.str_ref_size = out.end() - begin;
 }
 
 void TokenStream::scan_number()
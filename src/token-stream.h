@@ -3,6 +3,9 @@
    Use of this source code is governed by a BSD-style
    license that can be found in the LICENSE file.
 */
+#ifndef JSONCC_TOKEN_STREAM_H
+#define JSONCC_TOKEN_STREAM_H
+
 #include <inttypes.h>
 #include <string>
 
@@ -35,6 +38,9 @@ public:
 	int64_t int_value;
 	long double float_value;
 	std::string str_value;
+	// set instead of str_value if the string references the source
+	const char *str_ref;
+	size_t str_ref_size;
 
 	Token()
 	:
@@ -42,7 +48,9 @@ public:
 		number_type(NONE),
 		int_value(0),
 		float_value(0.0L),
-		str_value()
+		str_value(),
+		str_ref(nullptr),
+		str_ref_size(0)
 	{ }
 
 	void reset()
@@ -52,6 +60,8 @@ public:
 		int_value = 0;
 		float_value = 0.0L;
 		str_value.clear();
+		str_ref = nullptr;
+		str_ref_size = 0;
 	}
 };
 
@@ -59,7 +69,15 @@ class Utf8Stream;
 
 class TokenStream {
 public:
-	TokenStream(Utf8Stream &);
+	enum StringMode {
+		STRING_COPY,      // always decode into Token::str_value
+		STRING_REFERENCE, // reference strings without escapes
+		STRING_INSITU,    // decode in place, reference all strings
+	};
+
+	TokenStream(Utf8Stream &, StringMode = STRING_COPY);
+	// STRING_INSITU, buffer is the mutable source of the Utf8Stream
+	TokenStream(Utf8Stream &, char *buffer);
 
 	void scan(); // throws jsonp::Error
 
@@ -78,6 +96,10 @@ private:
 	void scan_number();
 
 	Utf8Stream & stream_;
+	StringMode string_mode_;
+	char *buffer_;
 };
 
 }
+
+#endif
@@ -3,6 +3,8 @@
    Use of this source code is governed by a BSD-style
    license that can be found in the LICENSE file.
 */
+#ifndef JSONCC_UTF8_H
+#define JSONCC_UTF8_H
 
 namespace Json {
 
@@ -16,3 +18,5 @@ private:
 };
 
 }
+
+#endif
@@ -75,6 +75,11 @@ Location Utf8Stream::location() const
 	return Location(pos_);
 }
 
+const char *Utf8Stream::cursor() const
+{
+	return buf_ + pos_;
+}
+
 void Utf8Stream::bad()
 {
 	bad_ = true;
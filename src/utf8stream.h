@@ -3,6 +3,9 @@
    Use of this source code is governed by a BSD-style
    license that can be found in the LICENSE file.
 */
+#ifndef JSONCC_UTF8STREAM_H
+#define JSONCC_UTF8STREAM_H
+
 #include <jsoncc.h>
 #include "utf8.h"
 
@@ -21,6 +24,7 @@ public:
 	int getc(); // throws jsonp::Error
 	void ungetc();
 	Location location() const;
+	const char *cursor() const;
 	void bad();
 
 private:
@@ -34,3 +38,5 @@ private:
 };
 
 }
+
+#endif
@@ -27,7 +27,7 @@ Value::Value(Value const& o)
 	clone(o);
 }
 
-Value::Value(Value&& o)
+Value::Value(Value&& o) noexcept
 :
 	tag_(TAG_INVALID)
 {
@@ -43,7 +43,7 @@ Value & Value::operator=(Value const& o)
 	return *this;
 }
 
-Value & Value::operator=(Value&& o)
+Value & Value::operator=(Value&& o) noexcept
 {
 	if (&o == this) {
 		return *this;
@@ -215,6 +215,20 @@ Value::Value(Array const& array)
 	type_.array_ = new Array(array);
 }
 
+Value::Value(Object && object)
+:
+	tag_(TAG_OBJECT)
+{
+	type_.object_ = new Object(std::move(object));
+}
+
+Value::Value(Array && array)
+:
+	tag_(TAG_ARRAY)
+{
+	type_.array_ = new Array(std::move(array));
+}
+
 void Value::set(Null const&)
 {
 	clear();
@@ -318,6 +332,20 @@ Object const& Value::object() const
 	return *type_.object_;
 }
 
+Array & Value::array()
+{
+	assert(tag_ == TAG_ARRAY);
+	assert(type_.array_);
+	return *type_.array_;
+}
+
+Object & Value::object()
+{
+	assert(tag_ == TAG_OBJECT);
+	assert(type_.object_);
+	return *type_.object_;
+}
+
 void ValueFactory<bool>::build(bool const& value, Value & res)
 {
 	if (value) {
@@ -0,0 +1,65 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#ifndef JSONCC_WRITER_IMPL_H
+#define JSONCC_WRITER_IMPL_H
+
+#include <vector>
+
+#include <jsoncc.h>
+#include "serializer.h"
+
+namespace Json {
+
+class WriterImpl {
+public:
+	WriterImpl(Sink *, Writer::Style, char indent_char, size_t indent_width);
+
+	// throw Json::Error
+	void value(Value const&);
+	void literal(char const*);
+	void number(Number const&);
+	void string(String const&);
+	void begin(bool object);
+	void key(String const&);
+	void quoted_key(char const *, size_t);
+	void end(bool object);
+
+	size_t depth() const;
+	void flush();
+
+	// Serializer output
+	void append(char const *, size_t);
+	void put(char);
+	void reference(char const *, size_t);
+
+	std::string buffer;
+
+private:
+	/* an open container of streamed calls */
+	struct Frame {
+		bool object;
+		bool first;
+		bool has_key;
+		std::string last_key; // STYLE_CANONICAL only
+	};
+
+	Frame & key_frame();
+	void before_value();
+	void after_value();
+	void flush_buffer();
+	void flush_full();
+
+	Sink *sink_;
+	bool referenced_;
+	size_t chunk_size_;
+	Writer::Style style_;
+	Serializer<WriterImpl> serializer_;
+	std::vector<Frame> open_;
+};
+
+}
+
+#endif
@@ -0,0 +1,499 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cstring>
+
+#include "writer-impl.h"
+#include "xxhash.h"
+
+#include "error.h"
+
+namespace {
+
+// buffered bytes handed to a Sink at once, by default
+const size_t CHUNK_SIZE(1 << 16);
+
+// string runs passed to Sink::write_reference()
+const size_t REFERENCE_MIN(1 << 12);
+
+/* Serializer output counting bytes only */
+class SizeOut {
+public:
+	SizeOut()
+	:
+		size(0)
+	{ }
+
+	void append(char const *, size_t len)
+	{
+		size += len;
+	}
+
+	void put(char)
+	{
+		++size;
+	}
+
+	void reference(char const *, size_t len)
+	{
+		size += len;
+	}
+
+	size_t size;
+};
+
+/* Serializer output to a buffer known to be large enough */
+class RawOut {
+public:
+	explicit RawOut(char *buf)
+	:
+		pos(buf)
+	{ }
+
+	void append(char const *data, size_t len)
+	{
+		memcpy(pos, data, len);
+		pos += len;
+	}
+
+	void put(char c)
+	{
+		*pos++ = c;
+	}
+
+	void reference(char const *data, size_t len)
+	{
+		append(data, len);
+	}
+
+	char *pos;
+};
+
+}
+
+namespace Json {
+
+Sink::~Sink()
+{ }
+
+bool Sink::write_reference(char const *data, size_t size)
+{
+	write(data, size);
+	return false;
+}
+
+void Sink::flush()
+{ }
+
+size_t Sink::chunk_size() const
+{
+	return CHUNK_SIZE;
+}
+
+WriterImpl::WriterImpl(Sink *sink, Writer::Style style,
+	char indent_char, size_t indent_width)
+:
+	buffer(),
+	sink_(sink),
+	referenced_(false),
+	chunk_size_(sink ? sink->chunk_size() : CHUNK_SIZE),
+	style_(style),
+	serializer_(*this, style, indent_char, indent_width),
+	open_()
+{
+	if (sink_) {
+		buffer.reserve(chunk_size_);
+	}
+}
+
+void WriterImpl::value(Value const& value)
+{
+	before_value();
+	serializer_.value(value);
+	after_value();
+}
+
+void WriterImpl::literal(char const* lit)
+{
+	before_value();
+	serializer_.literal(lit);
+}
+
+void WriterImpl::number(Number const& number)
+{
+	before_value();
+	serializer_.number(number);
+}
+
+void WriterImpl::string(String const& string)
+{
+	before_value();
+	serializer_.string(string);
+	after_value();
+}
+
+void WriterImpl::begin(bool object)
+{
+	before_value();
+	serializer_.begin(object ? '{' : '[');
+	open_.push_back(Frame{object, true, false, std::string()});
+}
+
+void WriterImpl::key(String const& key)
+{
+	auto & frame(key_frame());
+	if (style_ == Writer::STYLE_CANONICAL) {
+		auto last(String::reference(frame.last_key.data(), frame.last_key.size()));
+		if (!frame.first && !canonical_less(last, key)) {
+			JSONCC_THROW(BAD_WRITER_CALL);
+		}
+		frame.last_key.assign(key.data(), key.size());
+	}
+
+	serializer_.separator(frame.first);
+	serializer_.key(key);
+	frame.has_key = true;
+	if (referenced_) {
+		flush();
+	}
+}
+
+void WriterImpl::quoted_key(char const *quoted, size_t size)
+{
+	// canonical keys are checked for order and have no space
+	if (style_ == Writer::STYLE_CANONICAL) {
+		key(String::reference(quoted + 1, size - 4));
+		return;
+	}
+
+	auto & frame(key_frame());
+	serializer_.separator(frame.first);
+	append(quoted, size);
+	frame.has_key = true;
+}
+
+void WriterImpl::end(bool object)
+{
+	if (open_.empty() || open_.back().object != object || open_.back().has_key) {
+		JSONCC_THROW(BAD_WRITER_CALL);
+	}
+
+	serializer_.end(object ? '}' : ']', open_.back().first);
+	open_.pop_back();
+}
+
+size_t WriterImpl::depth() const
+{
+	return open_.size();
+}
+
+WriterImpl::Frame & WriterImpl::key_frame()
+{
+	if (open_.empty() || !open_.back().object || open_.back().has_key) {
+		JSONCC_THROW(BAD_WRITER_CALL);
+	}
+	return open_.back();
+}
+
+void WriterImpl::before_value()
+{
+	if (open_.empty()) {
+		return;
+	}
+
+	auto & frame(open_.back());
+	if (frame.object) {
+		if (!frame.has_key) {
+			JSONCC_THROW(BAD_WRITER_CALL);
+		}
+		frame.has_key = false;
+	} else {
+		serializer_.separator(frame.first);
+	}
+}
+
+/* release references passed to the sink */
+void WriterImpl::after_value()
+{
+	if (referenced_) {
+		flush();
+	}
+}
+
+void WriterImpl::flush()
+{
+	if (sink_) {
+		flush_buffer();
+		sink_->flush();
+		referenced_ = false;
+	}
+}
+
+void WriterImpl::flush_buffer()
+{
+	if (sink_ && !buffer.empty()) {
+		sink_->write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+}
+
+void WriterImpl::append(char const *data, size_t size)
+{
+	buffer.append(data, size);
+	flush_full();
+}
+
+void WriterImpl::put(char c)
+{
+	buffer.push_back(c);
+	flush_full();
+}
+
+void WriterImpl::reference(char const *data, size_t size)
+{
+	if (!sink_ || size < REFERENCE_MIN) {
+		append(data, size);
+		return;
+	}
+
+	flush_buffer();
+	if (sink_->write_reference(data, size)) {
+		referenced_ = true;
+	}
+}
+
+void WriterImpl::flush_full()
+{
+	if (buffer.size() >= chunk_size_) {
+		flush_buffer();
+	}
+}
+
+Writer::Writer(Style style, char indent_char, size_t indent_width)
+:
+	impl_(new WriterImpl(nullptr, style, indent_char, indent_width))
+{ }
+
+Writer::Writer(Sink & sink, Style style, char indent_char, size_t indent_width)
+:
+	impl_(new WriterImpl(&sink, style, indent_char, indent_width))
+{ }
+
+Writer::~Writer()
+{
+	try {
+		impl_->flush();
+	} catch (Error const&) {
+	}
+}
+
+Writer & Writer::value(Value const& value)
+{
+	impl_->value(value);
+	return *this;
+}
+
+Writer & Writer::null()
+{
+	impl_->literal("null");
+	return *this;
+}
+
+Writer & Writer::boolean(bool value)
+{
+	impl_->literal(value ? "true" : "false");
+	return *this;
+}
+
+Writer & Writer::number(Number const& number)
+{
+	impl_->number(number);
+	return *this;
+}
+
+Writer & Writer::string(String const& string)
+{
+	impl_->string(string);
+	return *this;
+}
+
+Writer & Writer::begin_object()
+{
+	impl_->begin(true);
+	return *this;
+}
+
+Writer & Writer::key(String const& key)
+{
+	impl_->key(key);
+	return *this;
+}
+
+Writer & Writer::quoted_key(char const *quoted, size_t size)
+{
+	impl_->quoted_key(quoted, size);
+	return *this;
+}
+
+Writer & Writer::end_object()
+{
+	impl_->end(true);
+	return *this;
+}
+
+Writer & Writer::begin_array()
+{
+	impl_->begin(false);
+	return *this;
+}
+
+Writer & Writer::end_array()
+{
+	impl_->end(false);
+	return *this;
+}
+
+size_t Writer::depth() const
+{
+	return impl_->depth();
+}
+
+void Writer::flush()
+{
+	impl_->flush();
+}
+
+char const* Writer::data() const
+{
+	return impl_->buffer.data();
+}
+
+size_t Writer::size() const
+{
+	return impl_->buffer.size();
+}
+
+std::string Writer::str() const
+{
+	return impl_->buffer;
+}
+
+void Writer::clear()
+{
+	impl_->buffer.clear();
+}
+
+void ValueWriter<bool>::write(Writer & writer, bool const& v)
+{
+	writer.boolean(v);
+}
+
+void ValueWriter<uint8_t>::write(Writer & writer, uint8_t const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<int8_t>::write(Writer & writer, int8_t const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<uint16_t>::write(Writer & writer, uint16_t const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<int16_t>::write(Writer & writer, int16_t const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<uint32_t>::write(Writer & writer, uint32_t const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<int32_t>::write(Writer & writer, int32_t const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<uint64_t>::write(Writer & writer, uint64_t const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<int64_t>::write(Writer & writer, int64_t const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<float>::write(Writer & writer, float const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<double>::write(Writer & writer, double const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<long double>::write(Writer & writer, long double const& v)
+{
+	writer.number(v);
+}
+
+void ValueWriter<std::string>::write(Writer & writer, std::string const& v)
+{
+	writer.string(String::reference(v.data(), v.size()));
+}
+
+void ValueWriter<Value>::write(Writer & writer, Value const& v)
+{
+	writer.value(v);
+}
+
+size_t serialized_size(Value const& value, Writer::Style style,
+	char indent_char, size_t indent_width)
+{
+	SizeOut out;
+	Serializer<SizeOut>(out, style, indent_char, indent_width).value(value);
+	return out.size;
+}
+
+size_t serialize(Value const& value, char *buf, Writer::Style style,
+	char indent_char, size_t indent_width)
+{
+	RawOut out(buf);
+	Serializer<RawOut>(out, style, indent_char, indent_width).value(value);
+	return out.pos - buf;
+}
+
+HashSink::HashSink(uint64_t seed)
+:
+	impl_(new XXH64(seed))
+{ }
+
+HashSink::~HashSink()
+{ }
+
+void HashSink::write(char const *data, size_t size)
+{
+	impl_->update(data, size);
+}
+
+uint64_t HashSink::digest() const
+{
+	return impl_->digest();
+}
+
+uint64_t canonical_hash(Value const& value, uint64_t seed)
+{
+	XXH64 hash(seed);
+	Serializer<XXH64>(hash, Writer::STYLE_CANONICAL).value(value);
+	return hash.digest();
+}
+
+}
@@ -0,0 +1,147 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#include <cstring>
+
+#include "xxhash.h"
+
+namespace {
+
+const uint64_t PRIME1(0x9e3779b185ebca87ULL);
+const uint64_t PRIME2(0xc2b2ae3d27d4eb4fULL);
+const uint64_t PRIME3(0x165667b19e3779f9ULL);
+const uint64_t PRIME4(0x85ebca77c2b2ae63ULL);
+const uint64_t PRIME5(0x27d4eb2f165667c5ULL);
+
+uint64_t rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+uint64_t read64(unsigned char const *p)
+{
+	uint64_t res(0);
+	for (int i(7); i >= 0; --i) {
+		res = (res << 8) | p[i];
+	}
+	return res;
+}
+
+uint32_t read32(unsigned char const *p)
+{
+	return uint32_t(p[0]) | uint32_t(p[1]) << 8 |
+		uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+uint64_t lane_round(uint64_t acc, uint64_t lane)
+{
+	return rotl(acc + lane * PRIME2, 31) * PRIME1;
+}
+
+uint64_t merge_round(uint64_t acc, uint64_t v)
+{
+	return (acc ^ lane_round(0, v)) * PRIME1 + PRIME4;
+}
+
+}
+
+namespace Json {
+
+XXH64::XXH64(uint64_t seed)
+:
+	seed_(seed),
+	v_{seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1},
+	total_(0),
+	buf_(),
+	fill_(0)
+{ }
+
+void XXH64::stripe(unsigned char const *p)
+{
+	for (int i(0); i < 4; ++i) {
+		v_[i] = lane_round(v_[i], read64(p + 8 * i));
+	}
+}
+
+void XXH64::update(char const *data, size_t size)
+{
+	auto p(reinterpret_cast<unsigned char const *>(data));
+	total_ += size;
+
+	if (fill_) {
+		auto len(size < 32 - fill_ ? size : 32 - fill_);
+		memcpy(buf_ + fill_, p, len);
+		fill_ += len;
+		p += len;
+		size -= len;
+		if (fill_ < 32) {
+			return;
+		}
+		stripe(buf_);
+		fill_ = 0;
+	}
+
+	for (; size >= 32; p += 32, size -= 32) {
+		stripe(p);
+	}
+
+	memcpy(buf_, p, size);
+	fill_ = size;
+}
+
+uint64_t XXH64::digest() const
+{
+	uint64_t h;
+	if (total_ >= 32) {
+		h = rotl(v_[0], 1) + rotl(v_[1], 7) + rotl(v_[2], 12) + rotl(v_[3], 18);
+		for (int i(0); i < 4; ++i) {
+			h = merge_round(h, v_[i]);
+		}
+	} else {
+		h = seed_ + PRIME5;
+	}
+	h += total_;
+
+	auto p(buf_);
+	auto size(fill_);
+	for (; size >= 8; p += 8, size -= 8) {
+		h ^= lane_round(0, read64(p));
+		h = rotl(h, 27) * PRIME1 + PRIME4;
+	}
+	if (size >= 4) {
+		h ^= uint64_t(read32(p)) * PRIME1;
+		h = rotl(h, 23) * PRIME2 + PRIME3;
+		p += 4;
+		size -= 4;
+	}
+	for (; size; ++p, --size) {
+		h ^= *p * PRIME5;
+		h = rotl(h, 11) * PRIME1;
+	}
+
+	h ^= h >> 33;
+	h *= PRIME2;
+	h ^= h >> 29;
+	h *= PRIME3;
+	h ^= h >> 32;
+	return h;
+}
+
+void XXH64::append(char const *data, size_t size)
+{
+	update(data, size);
+}
+
+void XXH64::put(char c)
+{
+	update(&c, 1);
+}
+
+void XXH64::reference(char const *data, size_t size)
+{
+	update(data, size);
+}
+
+}
@@ -0,0 +1,42 @@
+/*
+   Copyright (c) 2015 - 2018 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+ */
+#ifndef JSONCC_XXHASH_H
+#define JSONCC_XXHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Json {
+
+/*
+ * Streaming XXH64, the digest of all update() calls equals
+ * the digest of their concatenated input.
+ */
+class XXH64 {
+public:
+	explicit XXH64(uint64_t seed = 0);
+
+	void update(char const *, size_t);
+	uint64_t digest() const;
+
+	// Serializer output
+	void append(char const *, size_t);
+	void put(char);
+	void reference(char const *, size_t);
+
+private:
+	void stripe(unsigned char const *);
+
+	uint64_t seed_;
+	uint64_t v_[4];
+	uint64_t total_;
+	unsigned char buf_[32];
+	size_t fill_;
+};
+
+}
+
+#endif
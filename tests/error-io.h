@@ -32,6 +32,15 @@ static inline std::ostream & operator<<(std::ostream & os, Error::Type type)
 	CASE_ERROR_TYPE(Error::BAD_TOKEN_OBJECT_SEP);
 	CASE_ERROR_TYPE(Error::BAD_TOKEN_OBJECT_VALUE);
 	CASE_ERROR_TYPE(Error::BAD_TOKEN_OBJECT_NEXT);
+	CASE_ERROR_TYPE(Error::BAD_COLUMN_DOCUMENT);
+	CASE_ERROR_TYPE(Error::BAD_COLUMN_VALUE);
+	CASE_ERROR_TYPE(Error::BAD_WRITER_CALL);
+	CASE_ERROR_TYPE(Error::WRITE_FAILED);
+	CASE_ERROR_TYPE(Error::BAD_CANONICAL_NUMBER);
+	CASE_ERROR_TYPE(Error::BAD_READER_TYPE);
+	CASE_ERROR_TYPE(Error::BAD_PATCH);
+	CASE_ERROR_TYPE(Error::BAD_PATCH_PATH);
+	CASE_ERROR_TYPE(Error::PATCH_TEST_FAILED);
 	CASE_ERROR_TYPE(Error::INTERNAL_ERROR);
 	}
 #undef CASE_ERROR_TYPE
@@ -27,6 +27,11 @@ private:
 	void test_vector_nested();
 	void test_list();
 	void test_set();
+	void test_compact();
+	void test_compact_equality();
+	void test_compact_append();
+	void test_reserve();
+	void test_mutable();
 
 	CPPUNIT_TEST_SUITE(test);
 	CPPUNIT_TEST(test_empty);
@@ -42,6 +47,11 @@ private:
 	CPPUNIT_TEST(test_vector_nested);
 	CPPUNIT_TEST(test_list);
 	CPPUNIT_TEST(test_set);
+	CPPUNIT_TEST(test_compact);
+	CPPUNIT_TEST(test_compact_equality);
+	CPPUNIT_TEST(test_compact_append);
+	CPPUNIT_TEST(test_reserve);
+	CPPUNIT_TEST(test_mutable);
 	CPPUNIT_TEST_SUITE_END();
 };
 
@@ -332,4 +342,140 @@ void test::test_set()
 	CPPUNIT_ASSERT_EQUAL(expected, ss.str());
 }
 
+void test::test_compact()
+{
+	Json::Value ints(std::vector<int32_t>{1, -2, 3});
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_INT, ints.array().storage());
+	CPPUNIT_ASSERT_EQUAL(size_t(3), ints.array().size());
+	CPPUNIT_ASSERT(ints.array().int_values() == std::vector<int64_t>({1, -2, 3}));
+
+	Json::Value uints(std::list<uint16_t>{7, 8});
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_UINT, uints.array().storage());
+	CPPUNIT_ASSERT(uints.array().uint_values() == std::vector<uint64_t>({7, 8}));
+
+	Json::Value fps(std::set<float>{0.5f, 1.5f});
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_FP, fps.array().storage());
+	CPPUNIT_ASSERT(fps.array().fp_values() == std::vector<double>({0.5, 1.5}));
+
+	// elements need a Value each
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_VALUES,
+		Json::Value(std::vector<bool>{true}).array().storage());
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_VALUES,
+		Json::Value(std::vector<long double>{1.0L}).array().storage());
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_VALUES,
+		Json::Value(std::vector<std::string>{"a"}).array().storage());
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_VALUES,
+		Json::Value(std::vector<signed char>{1}).array().storage());
+
+	// characters are strings, as without compact storage
+	Json::Value chars(std::vector<char>{'a', 'b'});
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_VALUES, chars.array().storage());
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Array{Json::String("a"), Json::String("b")}), chars);
+
+	// elements are Numbers of the same type as single values
+	size_t i(0);
+	for (auto const& element: ints.array()) {
+		CPPUNIT_ASSERT_EQUAL(Json::Value(std::vector<int32_t>{1, -2, 3}[i]), element);
+		++i;
+	}
+	CPPUNIT_ASSERT_EQUAL(size_t(3), i);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(0.5f), fps.array().elements()[0]);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(1L),
+		Json::Value(std::vector<long>{1}).array().elements()[0]);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(1UL),
+		Json::Value(std::vector<unsigned long>{1}).array().elements()[0]);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(1LL),
+		Json::Value(std::vector<long long>{1}).array().elements()[0]);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(1ULL),
+		Json::Value(std::vector<unsigned long long>{1}).array().elements()[0]);
+
+	std::stringstream ss;
+	ss << Json::noindent << ints << uints << fps;
+	CPPUNIT_ASSERT_EQUAL(std::string("[1, -2, 3][7, 8][0.5, 1.5]"), ss.str());
+}
+
+void test::test_compact_equality()
+{
+	Json::Value compact(std::vector<double>{0.25, -1.0});
+	Json::Value values(Json::Array{Json::Number(0.25), Json::Number(-1.0)});
+
+	CPPUNIT_ASSERT_EQUAL(values, compact);
+	CPPUNIT_ASSERT_EQUAL(compact, values);
+	CPPUNIT_ASSERT_EQUAL(compact, Json::Value(std::list<double>{0.25, -1.0}));
+	CPPUNIT_ASSERT(!Json::equal(compact, Json::Value(std::vector<double>{0.25, 1.0})));
+
+	// Number types differ
+	Json::Value ints(std::vector<int>{1});
+	CPPUNIT_ASSERT(!Json::equal(ints, Json::Value(std::vector<unsigned>{1})));
+	CPPUNIT_ASSERT(!Json::equal(ints, Json::Value(std::vector<double>{1})));
+}
+
+void test::test_compact_append()
+{
+	auto compact(Json::Array::numbers(std::vector<int64_t>{1, 2}));
+	Json::Array copy(compact);
+
+	compact << Json::String("x");
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_VALUES, compact.storage());
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_INT, copy.storage());
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Array{
+		Json::Number(1), Json::Number(2), Json::String("x")}), Json::Value(compact));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), copy.size());
+}
+
+void test::test_reserve()
+{
+	Json::Array a;
+	a.reserve(100);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), a.size());
+	CPPUNIT_ASSERT(a.capacity() >= 100);
+
+	a << Json::Number(0);
+	auto first(&*a.begin());
+	for (int i(1); i < 100; ++i) {
+		a << Json::Number(i);
+	}
+	// no reallocation
+	CPPUNIT_ASSERT_EQUAL(first, &*a.begin());
+
+	a.reserve(1000);
+	a.shrink_to_fit();
+	CPPUNIT_ASSERT_EQUAL(size_t(100), a.size());
+	CPPUNIT_ASSERT(a.capacity() < 1000);
+
+	// compact arrays are converted
+	auto compact(Json::Array::numbers(std::vector<int64_t>{1, 2}));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), compact.capacity());
+	compact.reserve(10);
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_VALUES, compact.storage());
+	CPPUNIT_ASSERT(compact.capacity() >= 10);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Array{
+		Json::Number(1), Json::Number(2)}), Json::Value(compact));
+}
+
+void test::test_mutable()
+{
+	Json::Array a{Json::Number(1), Json::Array{Json::Number(2)}};
+	a[0] = Json::String("x");
+	a[1].array() << Json::Number(3);
+	a.insert(0, Json::Null());
+	a.insert(3, Json::True());
+	a.erase(1);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Array{
+		Json::Null(),
+		Json::Array{Json::Number(2), Json::Number(3)},
+		Json::True()}), Json::Value(a));
+
+	// const access keeps compact storage
+	auto compact(Json::Array::numbers(std::vector<int64_t>{1, 2}));
+	Json::Array const& ref(compact);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Number(2)), ref[1]);
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_INT, compact.storage());
+	Json::Array copy(compact);
+	compact[1] = Json::Number(5);
+	CPPUNIT_ASSERT_EQUAL(Json::Array::STORAGE_VALUES, compact.storage());
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Number(5)), compact[1]);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Number(2)), copy[1]);
+}
+
 }}}
@@ -0,0 +1,216 @@
+#include <cmath>
+#include <cstring>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include "error-assert.h"
+#include "error-io.h"
+#include "xxhash.h"
+
+namespace unittests {
+namespace canonical {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_numbers();
+	void test_bad_numbers();
+	void test_key_order();
+	void test_document();
+	void test_stream();
+	void test_xxh64();
+	void test_hash();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_numbers);
+	CPPUNIT_TEST(test_bad_numbers);
+	CPPUNIT_TEST(test_key_order);
+	CPPUNIT_TEST(test_document);
+	CPPUNIT_TEST(test_stream);
+	CPPUNIT_TEST(test_xxh64);
+	CPPUNIT_TEST(test_hash);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+namespace {
+
+std::string canonical(Json::Value const& value)
+{
+	Json::Writer writer(Json::Writer::STYLE_CANONICAL);
+	writer.value(value);
+	return writer.str();
+}
+
+uint64_t xxh64(std::string const& str, uint64_t seed = 0)
+{
+	Json::XXH64 hash(seed);
+	hash.update(str.data(), str.size());
+	return hash.digest();
+}
+
+}
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_numbers()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), canonical(Json::Number(0.0)));
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), canonical(Json::Number(-0.0)));
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), canonical(Json::Number(0)));
+	CPPUNIT_ASSERT_EQUAL(std::string("-1"), canonical(Json::Number(-1)));
+	CPPUNIT_ASSERT_EQUAL(std::string("4.5"), canonical(Json::Number(4.50)));
+	CPPUNIT_ASSERT_EQUAL(std::string("0.002"), canonical(Json::Number(2e-3)));
+	CPPUNIT_ASSERT_EQUAL(std::string("1e-7"), canonical(Json::Number(1e-7)));
+	CPPUNIT_ASSERT_EQUAL(std::string("1e+21"), canonical(Json::Number(1e21)));
+	CPPUNIT_ASSERT_EQUAL(std::string("100000000000000000000"), canonical(Json::Number(1e20)));
+	CPPUNIT_ASSERT_EQUAL(std::string("333333333.3333333"),
+		canonical(Json::Number(333333333.33333329)));
+	CPPUNIT_ASSERT_EQUAL(std::string("9007199254740992"),
+		canonical(Json::Number(uint64_t(9007199254740992ULL))));
+	CPPUNIT_ASSERT_EQUAL(std::string("-5e-324"), canonical(Json::Number(-5e-324)));
+	CPPUNIT_ASSERT_EQUAL(std::string("1.7976931348623157e+308"),
+		canonical(Json::Number(1.7976931348623157e308)));
+	// shortest digits where Grisu2 writes 17
+	CPPUNIT_ASSERT_EQUAL(std::string("-3.556169393814842e-26"),
+		canonical(Json::Number(-3.5561693938148423e-26)));
+	CPPUNIT_ASSERT_EQUAL(std::string("1e+23"), canonical(Json::Number(1e23)));
+}
+
+void test::test_bad_numbers()
+{
+	for (auto value: {double(NAN), HUGE_VAL, -HUGE_VAL}) {
+		Json::Writer writer(Json::Writer::STYLE_CANONICAL);
+		Json::Error error;
+		CPPUNIT_ASSERT_THROW_VAR(writer.value(Json::Number(value)), Json::Error, error);
+		CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_CANONICAL_NUMBER, error.type);
+	}
+}
+
+void test::test_key_order()
+{
+	// RFC 8785 3.2.3, sorted by UTF-16 code units
+	Json::Object object{
+		{"\xe2\x82\xac", Json::String("Euro Sign")},
+		{"\r", Json::String("Carriage Return")},
+		{"\xef\xac\xb3", Json::String("Hebrew Letter Dalet With Dagesh")},
+		{"1", Json::String("One")},
+		{"\xf0\x9f\x98\x80", Json::String("Emoji: Grinning Face")},
+		{"\xc2\x80", Json::String("Control")},
+		{"\xc3\xb6", Json::String("Latin Small Letter O With Diaeresis")},
+	};
+
+	CPPUNIT_ASSERT_EQUAL(std::string("{"
+		"\"\\r\":\"Carriage Return\","
+		"\"1\":\"One\","
+		"\"\xc2\x80\":\"Control\","
+		"\"\xc3\xb6\":\"Latin Small Letter O With Diaeresis\","
+		"\"\xe2\x82\xac\":\"Euro Sign\","
+		"\"\xf0\x9f\x98\x80\":\"Emoji: Grinning Face\","
+		"\"\xef\xac\xb3\":\"Hebrew Letter Dalet With Dagesh\""
+		"}"), canonical(object));
+
+	CPPUNIT_ASSERT_EQUAL(std::string("{\"a\":1,\"ab\":2,\"b\":3}"), canonical(Json::Object{
+		{"b", Json::Number(3)}, {"ab", Json::Number(2)}, {"a", Json::Number(1)}}));
+}
+
+void test::test_document()
+{
+	// RFC 8785 3.2.4
+	char data[] =
+		"{\n"
+		"  \"numbers\": [333333333.33333329, 1E30, 4.50, 2e-3, 0.000000000000000000000000001],\n"
+		"  \"string\": \"\\u20ac$\\u000F\\u000aA'\\u0042\\u0022\\u005c\\\\\\\"\\/\",\n"
+		"  \"literals\": [null, true, false]\n"
+		"}";
+	Json::Parser parser;
+	auto value(parser.parse(data, sizeof(data) - 1));
+
+	CPPUNIT_ASSERT_EQUAL(std::string(
+		"{\"literals\":[null,true,false],"
+		"\"numbers\":[333333333.3333333,1e+30,4.5,0.002,1e-27],"
+		"\"string\":\"\xe2\x82\xac$\\u000f\\nA'B\\\"\\\\\\\\\\\"/\"}"),
+		canonical(value));
+}
+
+void test::test_stream()
+{
+	Json::Writer writer(Json::Writer::STYLE_CANONICAL);
+	writer.begin_object()
+		.key("a").begin_array().value(Json::Number(1.0)).value(Json::Null()).end_array()
+		.key("b").begin_object().end_object()
+	.end_object();
+	CPPUNIT_ASSERT_EQUAL(std::string("{\"a\":[1,null],\"b\":{}}"), writer.str());
+
+	const char *bad_orders[][2] = {
+		{"b", "a"},
+		{"a", "a"},
+		{"\xef\xac\xb3", "\xf0\x9f\x98\x80"},
+	};
+	for (auto keys: bad_orders) {
+		Json::Writer w(Json::Writer::STYLE_CANONICAL);
+		w.begin_object().key(keys[0]).value(Json::Null());
+		Json::Error error;
+		CPPUNIT_ASSERT_THROW_VAR(w.key(keys[1]), Json::Error, error);
+		CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_WRITER_CALL, error.type);
+	}
+}
+
+void test::test_xxh64()
+{
+	CPPUNIT_ASSERT_EQUAL(uint64_t(0xef46db3751d8e999ULL), xxh64(""));
+	CPPUNIT_ASSERT_EQUAL(uint64_t(0x44bc2cf5ad770999ULL), xxh64("abc"));
+	CPPUNIT_ASSERT_EQUAL(uint64_t(0xfbcea83c8a378bf1ULL),
+		xxh64("Nobody inspects the spammish repetition"));
+
+	// split input hashes the same
+	std::string long_input(1000, 'x');
+	for (size_t i(0); i < long_input.size(); ++i) {
+		long_input[i] = 'a' + i % 26;
+	}
+	for (size_t split: {0, 1, 31, 32, 33, 500}) {
+		Json::XXH64 hash(7);
+		hash.update(long_input.data(), split);
+		hash.update(long_input.data() + split, long_input.size() - split);
+		CPPUNIT_ASSERT_EQUAL(xxh64(long_input, 7), hash.digest());
+	}
+}
+
+void test::test_hash()
+{
+	Json::Value value(Json::Object{
+		{"z", Json::Array{Json::Number(1), Json::String(std::string(100000, 's'))}},
+		{"a", Json::Object{{"y", Json::True()}, {"x", Json::Number(0.5)}}},
+	});
+	Json::Value reordered(Json::Object{
+		{"a", Json::Object{{"x", Json::Number(0.5)}, {"y", Json::True()}}},
+		{"z", Json::Array{Json::Number(1.0), Json::String(std::string(100000, 's'))}},
+	});
+
+	auto hash(Json::canonical_hash(value));
+	CPPUNIT_ASSERT_EQUAL(xxh64(canonical(value)), hash);
+	CPPUNIT_ASSERT_EQUAL(hash, Json::canonical_hash(reordered));
+	CPPUNIT_ASSERT(hash != Json::canonical_hash(value, 1));
+	CPPUNIT_ASSERT(hash != Json::canonical_hash(Json::Array{value}));
+
+	Json::HashSink sink;
+	{
+		Json::Writer writer(sink, Json::Writer::STYLE_CANONICAL);
+		writer.value(reordered);
+	}
+	CPPUNIT_ASSERT_EQUAL(hash, sink.digest());
+}
+
+}}
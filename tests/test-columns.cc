@@ -0,0 +1,231 @@
+#include <cstring>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include "error-assert.h"
+#include "error-io.h"
+
+namespace unittests {
+namespace columns {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_empty();
+	void test_records();
+	void test_nulls();
+	void test_skip_members();
+	void test_duplicate_key();
+	void test_bad_document();
+	void test_bad_value();
+	void test_parse_no_throw();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_empty);
+	CPPUNIT_TEST(test_records);
+	CPPUNIT_TEST(test_nulls);
+	CPPUNIT_TEST(test_skip_members);
+	CPPUNIT_TEST(test_duplicate_key);
+	CPPUNIT_TEST(test_bad_document);
+	CPPUNIT_TEST(test_bad_value);
+	CPPUNIT_TEST(test_parse_no_throw);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_empty()
+{
+	Json::Parser parser;
+	std::vector<Json::Column> columns{
+		Json::Column("ts", Json::Column::TYPE_INT64),
+	};
+
+	char data[] = "[]";
+	parser.parse_columns(data, sizeof(data) - 1, columns);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), columns[0].size());
+	CPPUNIT_ASSERT(columns[0].int64_values().empty());
+}
+
+void test::test_records()
+{
+	Json::Parser parser;
+	std::vector<Json::Column> columns{
+		Json::Column("ts", Json::Column::TYPE_INT64),
+		Json::Column("v", Json::Column::TYPE_DOUBLE),
+		Json::Column("name", Json::Column::TYPE_STRING),
+		Json::Column("ok", Json::Column::TYPE_BOOL),
+	};
+
+	char data[] = "["
+		"{\"ts\": 1, \"v\": 0.5, \"name\": \"a\", \"ok\": true},"
+		"{\"ok\": false, \"name\": \"b\\n\", \"v\": 2, \"ts\": -2}"
+		"]";
+	parser.parse_columns(data, sizeof(data) - 1, columns);
+
+	for (auto & column: columns) {
+		CPPUNIT_ASSERT_EQUAL(size_t(2), column.size());
+		CPPUNIT_ASSERT(!column.null(0));
+		CPPUNIT_ASSERT(!column.null(1));
+	}
+
+	CPPUNIT_ASSERT_EQUAL(int64_t(1), columns[0].int64_values()[0]);
+	CPPUNIT_ASSERT_EQUAL(int64_t(-2), columns[0].int64_values()[1]);
+	CPPUNIT_ASSERT_EQUAL(0.5, columns[1].double_values()[0]);
+	CPPUNIT_ASSERT_EQUAL(2.0, columns[1].double_values()[1]);
+	CPPUNIT_ASSERT_EQUAL(std::string("a"), columns[2].string_values()[0]);
+	CPPUNIT_ASSERT_EQUAL(std::string("b\n"), columns[2].string_values()[1]);
+	CPPUNIT_ASSERT_EQUAL(true, bool(columns[3].bool_values()[0]));
+	CPPUNIT_ASSERT_EQUAL(false, bool(columns[3].bool_values()[1]));
+}
+
+void test::test_nulls()
+{
+	Json::Parser parser;
+	std::vector<Json::Column> columns{
+		Json::Column("ts", Json::Column::TYPE_INT64),
+		Json::Column("v", Json::Column::TYPE_DOUBLE),
+	};
+
+	char data[] = "[{\"ts\": null, \"v\": 1.5}, {\"ts\": 7}, {}]";
+	parser.parse_columns(data, sizeof(data) - 1, columns);
+
+	CPPUNIT_ASSERT_EQUAL(size_t(3), columns[0].size());
+	CPPUNIT_ASSERT_EQUAL(size_t(3), columns[1].size());
+
+	CPPUNIT_ASSERT(columns[0].null(0));
+	CPPUNIT_ASSERT(!columns[0].null(1));
+	CPPUNIT_ASSERT(columns[0].null(2));
+	CPPUNIT_ASSERT_EQUAL(int64_t(0), columns[0].int64_values()[0]);
+	CPPUNIT_ASSERT_EQUAL(int64_t(7), columns[0].int64_values()[1]);
+
+	CPPUNIT_ASSERT(!columns[1].null(0));
+	CPPUNIT_ASSERT(columns[1].null(1));
+	CPPUNIT_ASSERT(columns[1].null(2));
+	CPPUNIT_ASSERT_EQUAL(1.5, columns[1].double_values()[0]);
+
+	// columns are reset on each run
+	char data2[] = "[{\"ts\": 3}]";
+	parser.parse_columns(data2, sizeof(data2) - 1, columns);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), columns[0].size());
+	CPPUNIT_ASSERT_EQUAL(int64_t(3), columns[0].int64_values()[0]);
+	CPPUNIT_ASSERT(columns[1].null(0));
+}
+
+void test::test_skip_members()
+{
+	Json::Parser parser;
+	std::vector<Json::Column> columns{
+		Json::Column("v", Json::Column::TYPE_INT64),
+	};
+
+	char data[] = "[{\"a\": [1, {\"v\": \"x\"}], \"v\": 1, \"b\": {\"v\": []}}]";
+	parser.parse_columns(data, sizeof(data) - 1, columns);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), columns[0].size());
+	CPPUNIT_ASSERT_EQUAL(int64_t(1), columns[0].int64_values()[0]);
+}
+
+void test::test_duplicate_key()
+{
+	Json::Parser parser;
+	std::vector<Json::Column> columns{
+		Json::Column("v", Json::Column::TYPE_STRING),
+	};
+
+	char data[] = "[{\"v\": \"first\", \"v\": \"last\"}, {\"v\": \"x\", \"v\": null}]";
+	parser.parse_columns(data, sizeof(data) - 1, columns);
+	CPPUNIT_ASSERT_EQUAL(size_t(2), columns[0].size());
+	CPPUNIT_ASSERT_EQUAL(std::string("last"), columns[0].string_values()[0]);
+	CPPUNIT_ASSERT(columns[0].null(1));
+}
+
+void test::test_bad_document()
+{
+	Json::Parser parser;
+	std::vector<Json::Column> columns{
+		Json::Column("v", Json::Column::TYPE_INT64),
+	};
+
+	const char *docs[] = {
+		"{\"v\": 1}",
+		"[1]",
+		"[{\"v\": 1}, []]",
+		"[{\"v\": 1}, null]",
+	};
+
+	for (auto doc: docs) {
+		Json::Error error;
+		CPPUNIT_ASSERT_THROW_VAR(
+			parser.parse_columns(doc, strlen(doc), columns), Json::Error, error);
+		CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_COLUMN_DOCUMENT, error.type);
+	}
+
+	char data[] = "[{\"v\": 1},";
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(
+		parser.parse_columns(data, sizeof(data) - 1, columns), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_TOKEN_ARRAY_NEXT, error.type);
+}
+
+void test::test_bad_value()
+{
+	Json::Parser parser;
+	std::vector<Json::Column> columns{
+		Json::Column("i", Json::Column::TYPE_INT64),
+		Json::Column("d", Json::Column::TYPE_DOUBLE),
+		Json::Column("s", Json::Column::TYPE_STRING),
+		Json::Column("b", Json::Column::TYPE_BOOL),
+	};
+
+	const char *docs[] = {
+		"[{\"i\": 1.5}]",
+		"[{\"i\": \"1\"}]",
+		"[{\"d\": true}]",
+		"[{\"s\": 1}]",
+		"[{\"b\": 0}]",
+		"[{\"s\": [\"x\"]}]",
+		"[{\"b\": {}}]",
+	};
+
+	for (auto doc: docs) {
+		Json::Error error;
+		CPPUNIT_ASSERT_THROW_VAR(
+			parser.parse_columns(doc, strlen(doc), columns), Json::Error, error);
+		CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_COLUMN_VALUE, error.type);
+	}
+}
+
+void test::test_parse_no_throw()
+{
+	Json::Parser parser;
+	std::vector<Json::Column> columns{
+		Json::Column("v", Json::Column::TYPE_BOOL),
+	};
+
+	char data[] = "[{\"v\": 1}]";
+	Json::Error error;
+	parser.parse_columns(data, sizeof(data) - 1, columns, error);
+	CPPUNIT_ASSERT(error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_COLUMN_VALUE, error.type);
+
+	char data2[] = "[{\"v\": true}]";
+	Json::Error error2;
+	parser.parse_columns(data2, sizeof(data2) - 1, columns, error2);
+	CPPUNIT_ASSERT(!error2);
+	CPPUNIT_ASSERT_EQUAL(true, bool(columns[0].bool_values()[0]));
+}
+
+}}
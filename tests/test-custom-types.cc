@@ -1,3 +1,5 @@
+#include <locale>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 namespace {
@@ -37,6 +39,47 @@ std::ostream & operator<<(std::ostream & os, ::Baz baz)
 	return os;
 }
 
+struct hex { int value; };
+
+struct dec { int value; };
+
+struct wrapper { };
+
+struct id { size_t length; };
+
+std::ostream & operator<<(std::ostream & os, ::hex const& h)
+{
+	return os << std::hex << std::showbase << h.value;
+}
+
+std::ostream & operator<<(std::ostream & os, ::dec const& d)
+{
+	return os << d.value;
+}
+
+struct thousands : std::numpunct<char> {
+	char do_thousands_sep() const { return '\''; }
+	std::string do_grouping() const { return "\3"; }
+};
+
+// leaves locale and exceptions modified
+struct dirty { int value; };
+
+struct failing { };
+
+std::ostream & operator<<(std::ostream & os, ::dirty const& d)
+{
+	os.imbue(std::locale(os.getloc(), new thousands()));
+	os.exceptions(std::ios_base::badbit);
+	return os << d.value;
+}
+
+std::ostream & operator<<(std::ostream & os, ::failing const&)
+{
+	os.setstate(std::ios_base::badbit);
+	return os;
+}
+
 }
 
 // we have to place it here to keep clang++ happy.
@@ -46,6 +89,21 @@ std::ostream & operator<<(std::ostream & os, ::Baz baz)
 
 namespace Json {
 
+template<> struct ToChars< ::id> {
+	static const bool enabled = true;
+
+	static char *format(char *first, char *last, ::id const& v)
+	{
+		if (size_t(last - first) < v.length) {
+			return nullptr;
+		}
+		for (size_t i(0); i < v.length; ++i) {
+			first[i] = 'a' + i % 26;
+		}
+		return first + v.length;
+	}
+};
+
 template<> struct ValueFactory< ::foo> {
 	static void build(foo const& f, Value & res)
 	{
@@ -59,6 +117,16 @@ template<> struct ValueFactory< ::foo> {
 
 }
 
+namespace {
+
+// formats a Value from within operator<<
+std::ostream & operator<<(std::ostream & os, ::wrapper const&)
+{
+	return os << Json::noindent << Json::Value(Json::Array{::bar()});
+}
+
+}
+
 namespace unittests {
 namespace custom_type {
 
@@ -73,12 +141,18 @@ private:
 	void test_custom_type_vector();
 	void test_streamable_object();
 	void test_streamable_enum();
+	void test_format_state();
+	void test_nested_format();
+	void test_to_chars();
 
 	CPPUNIT_TEST_SUITE(test);
 	CPPUNIT_TEST(test_custom_type);
 	CPPUNIT_TEST(test_custom_type_vector);
 	CPPUNIT_TEST(test_streamable_object);
 	CPPUNIT_TEST(test_streamable_enum);
+	CPPUNIT_TEST(test_format_state);
+	CPPUNIT_TEST(test_nested_format);
+	CPPUNIT_TEST(test_to_chars);
 	CPPUNIT_TEST_SUITE_END();
 };
 
@@ -180,4 +254,32 @@ void test::test_streamable_enum()
 	CPPUNIT_ASSERT_EQUAL(expected, ss.str());
 }
 
+void test::test_format_state()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("0xff"), Json::Value(::hex{255}).string().value());
+	CPPUNIT_ASSERT_EQUAL(std::string("255"), Json::Value(::dec{255}).string().value());
+
+	CPPUNIT_ASSERT_EQUAL(std::string("1'234'567"),
+		Json::Value(::dirty{1234567}).string().value());
+	CPPUNIT_ASSERT_EQUAL(std::string("1234567"), Json::Value(::dec{1234567}).string().value());
+	CPPUNIT_ASSERT_EQUAL(std::string(""), Json::Value(::failing()).string().value());
+}
+
+void test::test_nested_format()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("[\"Bar Object\"]"),
+		Json::Value(::wrapper()).string().value());
+	CPPUNIT_ASSERT_EQUAL(std::string("Bar Object"), Json::Value(::bar()).string().value());
+}
+
+void test::test_to_chars()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("abc"), Json::Value(::id{3}).string().value());
+	CPPUNIT_ASSERT_EQUAL(std::string(""), Json::Value(::id{0}).string().value());
+
+	auto long_id(Json::Value(::id{1000}).string().value());
+	CPPUNIT_ASSERT_EQUAL(size_t(1000), long_id.size());
+	CPPUNIT_ASSERT_EQUAL('l', long_id[999]);
+}
+
 }}
@@ -0,0 +1,180 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include <jsoncc-cppunit.h>
+#include "dtoa.h"
+
+namespace unittests {
+namespace dtoa {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_layout();
+	void test_special();
+	void test_limits();
+	void test_round_trip();
+	void test_parse_round_trip();
+	void test_out_of_range();
+	void test_long_double();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_layout);
+	CPPUNIT_TEST(test_special);
+	CPPUNIT_TEST(test_limits);
+	CPPUNIT_TEST(test_round_trip);
+	CPPUNIT_TEST(test_parse_round_trip);
+	CPPUNIT_TEST(test_out_of_range);
+	CPPUNIT_TEST(test_long_double);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+namespace {
+
+std::string format(double value)
+{
+	char buf[Json::DTOA_BUFSIZE];
+	return std::string(buf, Json::dtoa(value, buf));
+}
+
+}
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_layout()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("1.0"), format(1.0));
+	CPPUNIT_ASSERT_EQUAL(std::string("-1.0"), format(-1.0));
+	CPPUNIT_ASSERT_EQUAL(std::string("0.5"), format(0.5));
+	CPPUNIT_ASSERT_EQUAL(std::string("0.1"), format(0.1));
+	CPPUNIT_ASSERT_EQUAL(std::string("123.456"), format(123.456));
+	CPPUNIT_ASSERT_EQUAL(std::string("12340000.0"), format(1234e4));
+	CPPUNIT_ASSERT_EQUAL(std::string("100000000000000000000.0"), format(1e20));
+	CPPUNIT_ASSERT_EQUAL(std::string("1e+21"), format(1e21));
+	CPPUNIT_ASSERT_EQUAL(std::string("1.5e+300"), format(1.5e300));
+	CPPUNIT_ASSERT_EQUAL(std::string("0.000001"), format(1e-6));
+	CPPUNIT_ASSERT_EQUAL(std::string("1e-7"), format(1e-7));
+	CPPUNIT_ASSERT_EQUAL(std::string("-1.234e-15"), format(-1.234e-15));
+	CPPUNIT_ASSERT_EQUAL(std::string("0.30000000000000004"), format(0.1 + 0.2));
+	// Grisu2 writes 17 digits
+	CPPUNIT_ASSERT_EQUAL(std::string("-3.556169393814842e-26"),
+		format(-3.5561693938148423e-26));
+}
+
+void test::test_special()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("0.0"), format(0.0));
+	CPPUNIT_ASSERT_EQUAL(std::string("-0.0"), format(-0.0));
+
+	Json::Value array(Json::Array{
+		Json::Number(HUGE_VAL), Json::Number(-HUGE_VAL), Json::Number(NAN)});
+	std::stringstream ss;
+	ss << Json::noindent << array;
+	CPPUNIT_ASSERT_EQUAL(std::string("[null, null, null]"), ss.str());
+}
+
+void test::test_limits()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("1.7976931348623157e+308"),
+		format(std::numeric_limits<double>::max()));
+	CPPUNIT_ASSERT_EQUAL(std::string("2.2250738585072014e-308"),
+		format(std::numeric_limits<double>::min()));
+	CPPUNIT_ASSERT_EQUAL(std::string("5e-324"),
+		format(std::numeric_limits<double>::denorm_min()));
+}
+
+void test::test_round_trip()
+{
+	uint64_t state(0x853c49e6748fea9bULL);
+	for (size_t i(0); i < 100000; ++i) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		double value;
+		memcpy(&value, &state, sizeof(value));
+		if (!std::isfinite(value)) {
+			continue;
+		}
+
+		auto str(format(value));
+		CPPUNIT_ASSERT(str.size() < Json::DTOA_BUFSIZE);
+		CPPUNIT_ASSERT_EQUAL(value, strtod(str.c_str(), nullptr));
+	}
+}
+
+void test::test_parse_round_trip()
+{
+	const double values[] = {
+		0.1, 1.0 / 3.0, 2.5e-7, 6.02214076e23, 1e300, 4.9e-324,
+		std::numeric_limits<double>::max(),
+	};
+
+	Json::Parser parser;
+	for (auto value: values) {
+		Json::Value array(Json::Array{Json::Number(value), Json::Number(-value)});
+		std::stringstream ss;
+		ss << Json::noindent << array;
+		auto str(ss.str());
+		auto res(parser.parse(str.data(), str.size()));
+		auto const& elements(res.array().elements());
+		CPPUNIT_ASSERT_EQUAL(value, double(elements[0].number().fp_value()));
+		CPPUNIT_ASSERT_EQUAL(-value, double(elements[1].number().fp_value()));
+
+		ss.str("");
+		ss << Json::noindent << res;
+		str = ss.str();
+		CPPUNIT_ASSERT_EQUAL(res, parser.parse(str.data(), str.size()));
+	}
+}
+
+void test::test_out_of_range()
+{
+	const std::string str("[1e400,-2.5e-400,0.1]");
+	Json::Parser parser;
+	auto value(parser.parse(str.data(), str.size()));
+
+	std::stringstream ss;
+	ss << Json::noindent << value;
+	CPPUNIT_ASSERT_EQUAL(std::string("[1e+400, -2.5e-400, 0.1]"), ss.str());
+	auto res(ss.str());
+	CPPUNIT_ASSERT_EQUAL(value, parser.parse(res.data(), res.size()));
+}
+
+void test::test_long_double()
+{
+	const std::string str("[0.1,-123.456,3.3333333333333333333]");
+	Json::Parser parser;
+	auto value(parser.parse(str.data(), str.size()));
+	auto const& elements(value.array().elements());
+	CPPUNIT_ASSERT(elements[0].number().fp_value() == 0.1L);
+	CPPUNIT_ASSERT(elements[1].number().fp_value() == -123.456L);
+
+	std::stringstream ss;
+	ss << Json::noindent << value;
+	auto res(ss.str());
+	CPPUNIT_ASSERT_EQUAL(0, res.compare(0, 15, "[0.1, -123.456,"));
+	CPPUNIT_ASSERT_EQUAL(value, parser.parse(res.data(), res.size()));
+
+	Json::Value third(Json::Array{Json::Number(1.0L / 3.0L)});
+	ss.str("");
+	ss << Json::noindent << third;
+	res = ss.str();
+	CPPUNIT_ASSERT_EQUAL(third, parser.parse(res.data(), res.size()));
+}
+
+}}
@@ -1,5 +1,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <unordered_set>
+
 #include <jsoncc.h>
 
 namespace unittests {
@@ -19,7 +21,11 @@ private:
 	void test_string();
 	void test_array();
 	void test_object();
+	void test_object_large();
 	void test_value();
+	void test_hash();
+	void test_hash_object();
+	void test_hash_unordered_set();
 
 	CPPUNIT_TEST_SUITE(test);
 	CPPUNIT_TEST(test_null);
@@ -29,7 +35,11 @@ private:
 	CPPUNIT_TEST(test_string);
 	CPPUNIT_TEST(test_array);
 	CPPUNIT_TEST(test_object);
+	CPPUNIT_TEST(test_object_large);
 	CPPUNIT_TEST(test_value);
+	CPPUNIT_TEST(test_hash);
+	CPPUNIT_TEST(test_hash_object);
+	CPPUNIT_TEST(test_hash_unordered_set);
 	CPPUNIT_TEST_SUITE_END();
 };
 
@@ -139,6 +149,45 @@ void test::test_object()
 	CPPUNIT_ASSERT(!Json::equal(o7, o8));
 }
 
+void test::test_object_large()
+{
+	Json::Object forward;
+	Json::Object backward;
+	for (int i(0); i < 50; ++i) {
+		forward << Json::Member(std::to_string(i), Json::Number(i));
+		backward << Json::Member(std::to_string(49 - i), Json::Number(49 - i));
+	}
+	CPPUNIT_ASSERT(Json::equal(forward, backward));
+
+	// same keys, one value differs
+	Json::Object changed(forward);
+	changed << Json::Member("x", Json::Number(1));
+	backward << Json::Member("x", Json::Number(2));
+	CPPUNIT_ASSERT(!Json::equal(changed, backward));
+	forward << Json::Member("x", Json::Number(2));
+	CPPUNIT_ASSERT(!Json::equal(changed, forward));
+
+	// different keys
+	forward << Json::Member("y", Json::Null());
+	backward << Json::Member("z", Json::Null());
+	CPPUNIT_ASSERT(!Json::equal(forward, backward));
+
+	// duplicate keys in any order
+	Json::Object dup1;
+	Json::Object dup2;
+	for (int i(0); i < 10; ++i) {
+		dup1 << Json::Member("a", Json::Number(i)) << Json::Member("b", Json::Number(i));
+		dup2 << Json::Member("a", Json::Number(9 - i)) << Json::Member("b", Json::Number(i));
+	}
+	CPPUNIT_ASSERT(Json::equal(dup1, dup2));
+	Json::Object dup3(dup2);
+	dup1 << Json::Member("a", Json::Number(0));
+	dup3 << Json::Member("b", Json::Number(0));
+	CPPUNIT_ASSERT(!Json::equal(dup1, dup3));
+	dup2 << Json::Member("a", Json::Number(1));
+	CPPUNIT_ASSERT(!Json::equal(dup1, dup2));
+}
+
 void test::test_value()
 {
 	CPPUNIT_ASSERT(Json::equal(Json::Value(), Json::Value()));
@@ -207,4 +256,92 @@ void test::test_value()
 	CPPUNIT_ASSERT(Json::equal(Json::Value(Json::Object()), Json::Value(Json::Object())));
 }
 
+void test::test_hash()
+{
+	CPPUNIT_ASSERT_EQUAL(Json::hash(Json::Value(Json::Null())), Json::hash(Json::Value(Json::Null())));
+	CPPUNIT_ASSERT(Json::hash(Json::Value(Json::True())) != Json::hash(Json::Value(Json::False())));
+
+	// Number types differ
+	CPPUNIT_ASSERT_EQUAL(Json::hash(Json::Number(1)), Json::hash(Json::Number(1)));
+	CPPUNIT_ASSERT(Json::hash(Json::Number(1)) != Json::hash(Json::Number(1u)));
+	CPPUNIT_ASSERT(Json::hash(Json::Number(1)) != Json::hash(Json::Number(1.0)));
+	CPPUNIT_ASSERT(Json::hash(Json::Number()) != Json::hash(Json::Number(0)));
+	CPPUNIT_ASSERT_EQUAL(Json::hash(Json::Number(0.0)), Json::hash(Json::Number(-0.0)));
+
+	CPPUNIT_ASSERT_EQUAL(Json::hash(Json::String()), Json::hash(Json::String("")));
+	CPPUNIT_ASSERT_EQUAL(Json::hash(Json::String("foo")),
+		Json::hash(Json::String::reference("foobar", 3)));
+	CPPUNIT_ASSERT(Json::hash(Json::String("foo")) != Json::hash(Json::String("bar")));
+
+	// arrays are ordered
+	Json::Array a{Json::Number(1), Json::String("x")};
+	Json::Array b{Json::String("x"), Json::Number(1)};
+	CPPUNIT_ASSERT(Json::hash(a) != Json::hash(b));
+	CPPUNIT_ASSERT(Json::hash(Json::Array{Json::Array()}) != Json::hash(Json::Array()));
+
+	// compact arrays hash like their elements
+	CPPUNIT_ASSERT_EQUAL(
+		Json::hash(Json::Array{Json::Number(-1), Json::Number(2)}),
+		Json::hash(Json::Array::numbers(std::vector<int64_t>{-1, 2})));
+	CPPUNIT_ASSERT_EQUAL(
+		Json::hash(Json::Array{Json::Number(1u), Json::Number(2u)}),
+		Json::hash(Json::Array::numbers(std::vector<uint64_t>{1, 2})));
+	CPPUNIT_ASSERT_EQUAL(
+		Json::hash(Json::Array{Json::Number(0.5), Json::Number(-0.0)}),
+		Json::hash(Json::Array::numbers(std::vector<double>{0.5, 0.0})));
+
+	// a Value hashes like its content
+	CPPUNIT_ASSERT_EQUAL(Json::hash(a), Json::hash(Json::Value(a)));
+	CPPUNIT_ASSERT_EQUAL(Json::hash(Json::Number(7)), Json::hash(Json::Value(Json::Number(7))));
+}
+
+void test::test_hash_object()
+{
+	Json::Object a{
+		{"a", Json::Number(1)},
+		{"b", Json::Array{Json::True()}},
+		{"c", Json::Object{{"d", Json::Null()}}},
+	};
+	Json::Object b{
+		{"c", Json::Object{{"d", Json::Null()}}},
+		{"a", Json::Number(1)},
+		{"b", Json::Array{Json::True()}},
+	};
+	CPPUNIT_ASSERT_EQUAL(Json::hash(a), Json::hash(b));
+
+	// keys and values are paired
+	Json::Object c{{"a", Json::Number(2)}, {"b", Json::Number(1)}};
+	Json::Object d{{"a", Json::Number(1)}, {"b", Json::Number(2)}};
+	CPPUNIT_ASSERT(Json::hash(c) != Json::hash(d));
+	CPPUNIT_ASSERT(!Json::equal(c, d));
+
+	// large objects are rejected by hash, equal ones still compare equal
+	Json::Object large;
+	Json::Object reversed;
+	for (int i(0); i < 100; ++i) {
+		large << Json::Member(std::to_string(i), Json::Number(i));
+		reversed << Json::Member(std::to_string(99 - i), Json::Number(99 - i));
+	}
+	CPPUNIT_ASSERT(Json::equal(large, reversed));
+	Json::Object other(large);
+	other << Json::Member("x", Json::Null());
+	reversed << Json::Member("x", Json::True());
+	CPPUNIT_ASSERT(!Json::equal(other, reversed));
+}
+
+void test::test_hash_unordered_set()
+{
+	std::unordered_set<Json::Value, std::hash<Json::Value>, Json::ValueEqual> set;
+	set.insert(Json::Value(Json::Object{{"a", Json::Number(1)}, {"b", Json::Null()}}));
+	set.insert(Json::Value(Json::Object{{"b", Json::Null()}, {"a", Json::Number(1)}}));
+	set.insert(Json::Value(std::vector<int>{1, 2, 3}));
+	set.insert(Json::Value(Json::Array{Json::Number(1), Json::Number(2), Json::Number(3)}));
+	set.insert(Json::Value(Json::Number(1u)));
+	set.insert(Json::Value(Json::Number(1)));
+
+	CPPUNIT_ASSERT_EQUAL(size_t(4), set.size());
+	CPPUNIT_ASSERT(set.count(Json::Value(Json::Number(1))));
+	CPPUNIT_ASSERT(!set.count(Json::Value(Json::Number(1.0))));
+}
+
 }}
@@ -0,0 +1,230 @@
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstdlib>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include "error-assert.h"
+#include "error-io.h"
+
+namespace {
+
+size_t writev_calls(0);
+
+}
+
+// counts the writev() calls of FdSink
+extern "C" ssize_t writev(int fd, const struct iovec *iov, int count)
+{
+	++writev_calls;
+	return syscall(SYS_writev, fd, iov, count);
+}
+
+namespace unittests {
+namespace fd_sink {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_small_writes();
+	void test_large_write();
+	void test_references();
+	void test_many_references();
+	void test_writer();
+	void test_writer_long_strings();
+	void test_writer_batching();
+	void test_bad_fd();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_small_writes);
+	CPPUNIT_TEST(test_large_write);
+	CPPUNIT_TEST(test_references);
+	CPPUNIT_TEST(test_many_references);
+	CPPUNIT_TEST(test_writer);
+	CPPUNIT_TEST(test_writer_long_strings);
+	CPPUNIT_TEST(test_writer_batching);
+	CPPUNIT_TEST(test_bad_fd);
+	CPPUNIT_TEST_SUITE_END();
+
+	std::string contents() const;
+
+	int fd_;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+test::test()
+:
+	fd_(-1)
+{ }
+
+void test::setUp()
+{
+	char path[] = "/tmp/jsoncc-test-XXXXXX";
+	fd_ = mkstemp(path);
+	CPPUNIT_ASSERT(fd_ >= 0);
+	unlink(path);
+}
+
+void test::tearDown()
+{
+	close(fd_);
+}
+
+std::string test::contents() const
+{
+	std::string res;
+	char buf[4096];
+	ssize_t len;
+	lseek(fd_, 0, SEEK_SET);
+	while ((len = read(fd_, buf, sizeof(buf))) > 0) {
+		res.append(buf, len);
+	}
+	return res;
+}
+
+void test::test_small_writes()
+{
+	std::string expected;
+	{
+		Json::FdSink sink(fd_, 3, 16);
+		for (int i(0); i < 100; ++i) {
+			auto chunk(std::to_string(i) + ",");
+			sink.write(chunk.data(), chunk.size());
+			expected += chunk;
+		}
+
+		sink.flush();
+		CPPUNIT_ASSERT_EQUAL(expected, contents());
+
+		sink.write("end", 3);
+		expected += "end";
+	}
+	CPPUNIT_ASSERT_EQUAL(expected, contents());
+}
+
+void test::test_large_write()
+{
+	Json::FdSink sink(fd_, 2, 16);
+	std::string large(1000, 'x');
+	sink.write("a", 1);
+	sink.write(large.data(), large.size());
+	CPPUNIT_ASSERT_EQUAL("a" + large, contents());
+}
+
+void test::test_references()
+{
+	std::string ref(64, 'r');
+	{
+		Json::FdSink sink(fd_, 2, 16, 32);
+		sink.write("<", 1);
+		sink.write_reference(ref.data(), ref.size());
+		sink.write_reference("short", 5);
+		sink.write(">", 1);
+	}
+	CPPUNIT_ASSERT_EQUAL("<" + ref + "short>", contents());
+}
+
+void test::test_many_references()
+{
+	std::string ref(8, 'r');
+	std::string expected;
+	{
+		Json::FdSink sink(fd_, 2, 16, 8);
+		for (int i(0); i < 5000; ++i) {
+			sink.write(",", 1);
+			sink.write_reference(ref.data(), ref.size());
+			expected += "," + ref;
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL(expected, contents());
+}
+
+void test::test_writer()
+{
+	Json::Value value(Json::Object{
+		{"long", Json::String(std::string(10000, 'l'))},
+		{"list", Json::Array{Json::Number(1), Json::String("a\nb")}},
+		{std::string(5000, 'k'), Json::Null()},
+	});
+
+	Json::Writer expected(Json::Writer::STYLE_NOINDENT);
+	expected.value(value);
+	{
+		Json::FdSink sink(fd_, 4, 1024, 1024);
+		Json::Writer writer(sink, Json::Writer::STYLE_NOINDENT);
+		writer.value(value);
+	}
+	CPPUNIT_ASSERT_EQUAL(expected.str(), contents());
+}
+
+void test::test_writer_long_strings()
+{
+	std::string str(4096, 's');
+	auto write([&str](Json::Writer & writer) {
+		writer.begin_array();
+		for (int i(0); i < 100; ++i) {
+			writer.string(str);
+		}
+		writer.end_array();
+	});
+
+	Json::Writer expected(Json::Writer::STYLE_NOINDENT);
+	write(expected);
+
+	writev_calls = 0;
+	{
+		Json::FdSink sink(fd_);
+		Json::Writer writer(sink, Json::Writer::STYLE_NOINDENT);
+		write(writer);
+	}
+	CPPUNIT_ASSERT_EQUAL(expected.str(), contents());
+
+	// the default sink copies, long strings cause no flushes
+	CPPUNIT_ASSERT(writev_calls <= expected.size() / (1 << 16) + 1);
+}
+
+void test::test_writer_batching()
+{
+	Json::Array array;
+	for (int i(0); i < 100000; ++i) {
+		array << Json::Number(i);
+	}
+
+	Json::Writer expected(Json::Writer::STYLE_NOINDENT);
+	expected.value(array);
+
+	writev_calls = 0;
+	{
+		Json::FdSink sink(fd_, 16, 1 << 14);
+		Json::Writer writer(sink, Json::Writer::STYLE_NOINDENT);
+		writer.value(array);
+	}
+	CPPUNIT_ASSERT_EQUAL(expected.str(), contents());
+
+	// one writev() per full ring of 256 KiB
+	const size_t ring(16 << 14);
+	CPPUNIT_ASSERT_EQUAL((expected.size() + ring - 1) / ring, writev_calls);
+}
+
+void test::test_bad_fd()
+{
+	Json::FdSink sink(-1, 1, 16);
+	sink.write("abc", 3);
+
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(sink.flush(), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::WRITE_FAILED, error.type);
+
+	// pending output was dropped
+	sink.flush();
+}
+
+}}
@@ -0,0 +1,206 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include <jsoncc-cppunit.h>
+#include "error-assert.h"
+#include "error-io.h"
+
+namespace unittests {
+namespace fields {
+
+struct Point {
+	int32_t x;
+	int32_t y;
+};
+
+struct Shape {
+	std::string name;
+	bool closed;
+	double scale;
+	std::vector<Point> points;
+	Point origin;
+};
+
+}}
+
+namespace Json {
+
+JSONCC_FIELDS(unittests::fields::Point, JSONCC_FIELD(x) JSONCC_FIELD(y))
+
+JSONCC_FIELDS(unittests::fields::Shape,
+	JSONCC_FIELD(name)
+	JSONCC_FIELD(closed)
+	JSONCC_FIELD(scale)
+	JSONCC_FIELD(points)
+	JSONCC_FIELD(origin))
+
+}
+
+namespace unittests {
+namespace fields {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_writer_scalars();
+	void test_write();
+	void test_build();
+	void test_read();
+	void test_read_unknown_members();
+	void test_canonical();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_writer_scalars);
+	CPPUNIT_TEST(test_write);
+	CPPUNIT_TEST(test_build);
+	CPPUNIT_TEST(test_read);
+	CPPUNIT_TEST(test_read_unknown_members);
+	CPPUNIT_TEST(test_canonical);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+namespace {
+
+Shape make_shape()
+{
+	Shape shape;
+	shape.name = "tri\"angle";
+	shape.closed = true;
+	shape.scale = 0.5;
+	shape.points = {{0, 0}, {4, 0}, {0, -3}};
+	shape.origin = {1, 2};
+	return shape;
+}
+
+template <typename T>
+std::string write(T const& v, Json::Writer::Style style = Json::Writer::STYLE_NOINDENT)
+{
+	Json::Writer writer(style);
+	Json::ValueWriter<T>::write(writer, v);
+	return writer.str();
+}
+
+}
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_writer_scalars()
+{
+	Json::Writer writer(Json::Writer::STYLE_NOINDENT);
+	writer.begin_array()
+		.null()
+		.boolean(true)
+		.boolean(false)
+		.number(-7)
+		.number(0.25)
+		.string("a\nb")
+	.end_array();
+	CPPUNIT_ASSERT_EQUAL(std::string("[null, true, false, -7, 0.25, \"a\\nb\"]"), writer.str());
+
+	Json::Writer bad;
+	bad.begin_object();
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(bad.number(1), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_WRITER_CALL, error.type);
+	CPPUNIT_ASSERT_THROW_VAR(bad.string("s"), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_WRITER_CALL, error.type);
+	CPPUNIT_ASSERT_THROW_VAR(bad.null(), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_WRITER_CALL, error.type);
+
+	// quoted keys follow the rules of key()
+	Json::Writer quoted(Json::Writer::STYLE_NOINDENT);
+	CPPUNIT_ASSERT_THROW_VAR(quoted.quoted_key("\"a\": ", 5), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_WRITER_CALL, error.type);
+	quoted.begin_object().quoted_key("\"a\": ", 5);
+	CPPUNIT_ASSERT_THROW_VAR(quoted.quoted_key("\"b\": ", 5), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_WRITER_CALL, error.type);
+	quoted.number(1).quoted_key("\"b\": ", 5).number(2).end_object();
+	CPPUNIT_ASSERT_EQUAL(std::string("{\"a\": 1, \"b\": 2}"), quoted.str());
+}
+
+void test::test_write()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("{\"x\": 1, \"y\": -2}"), write(Point{1, -2}));
+	CPPUNIT_ASSERT_EQUAL(std::string(
+		"{\"name\": \"tri\\\"angle\", \"closed\": true, \"scale\": 0.5, "
+		"\"points\": [{\"x\": 0, \"y\": 0}, {\"x\": 4, \"y\": 0}, {\"x\": 0, \"y\": -3}], "
+		"\"origin\": {\"x\": 1, \"y\": 2}}"), write(make_shape()));
+
+	// same as going through a Value
+	for (auto style: {Json::Writer::STYLE_INDENT, Json::Writer::STYLE_NOINDENT}) {
+		Json::Writer tree(style);
+		tree.value(Json::Value(make_shape()));
+		CPPUNIT_ASSERT_EQUAL(tree.str(), write(make_shape(), style));
+	}
+}
+
+void test::test_build()
+{
+	Json::Value expected(Json::Object{
+		{"x", Json::Number(3)},
+		{"y", Json::Number(4)},
+	});
+	CPPUNIT_ASSERT_EQUAL(expected, Json::Value(Point{3, 4}));
+}
+
+void test::test_read()
+{
+	auto data(write(make_shape()));
+	Json::Parser parser;
+	auto shape(parser.parse_into<Shape>(data.data(), data.size()));
+
+	CPPUNIT_ASSERT_EQUAL(std::string("tri\"angle"), shape.name);
+	CPPUNIT_ASSERT(shape.closed);
+	CPPUNIT_ASSERT_EQUAL(0.5, shape.scale);
+	CPPUNIT_ASSERT_EQUAL(size_t(3), shape.points.size());
+	CPPUNIT_ASSERT_EQUAL(int32_t(-3), shape.points[2].y);
+	CPPUNIT_ASSERT_EQUAL(int32_t(1), shape.origin.x);
+	CPPUNIT_ASSERT_EQUAL(int32_t(2), shape.origin.y);
+	CPPUNIT_ASSERT_EQUAL(data, write(shape));
+}
+
+void test::test_read_unknown_members()
+{
+	std::string data("{\"z\": [1, {\"x\": 5}], \"y\": 9, \"x\": 8, \"x\": 7}");
+	Json::Parser parser;
+	Point point{0, 0};
+	parser.parse_into(data.data(), data.size(), point);
+	CPPUNIT_ASSERT_EQUAL(int32_t(7), point.x);
+	CPPUNIT_ASSERT_EQUAL(int32_t(9), point.y);
+
+	// missing fields keep their value
+	point = Point{1, 2};
+	parser.parse_into("{}", 2, point);
+	CPPUNIT_ASSERT_EQUAL(int32_t(1), point.x);
+	CPPUNIT_ASSERT_EQUAL(int32_t(2), point.y);
+
+	Json::Error error;
+	parser.parse_into("{\"x\": \"1\"}", 10, point, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, error.type);
+}
+
+void test::test_canonical()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("{\"x\":1,\"y\":2}"),
+		write(Point{1, 2}, Json::Writer::STYLE_CANONICAL));
+
+	// Shape fields are not in canonical order
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(write(make_shape(), Json::Writer::STYLE_CANONICAL),
+		Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_WRITER_CALL, error.type);
+}
+
+}}
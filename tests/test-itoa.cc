@@ -0,0 +1,105 @@
+#include <inttypes.h>
+#include <cstdio>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include "itoa.h"
+
+namespace unittests {
+namespace itoa {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_unsigned();
+	void test_signed();
+	void test_random();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_unsigned);
+	CPPUNIT_TEST(test_signed);
+	CPPUNIT_TEST(test_random);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+namespace {
+
+std::string format_u(uint64_t value)
+{
+	char buf[Json::ITOA_BUFSIZE];
+	return std::string(buf, Json::u64toa(value, buf));
+}
+
+std::string format_i(int64_t value)
+{
+	char buf[Json::ITOA_BUFSIZE];
+	return std::string(buf, Json::i64toa(value, buf));
+}
+
+std::string printf_u(uint64_t value)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%" PRIu64, value);
+	return buf;
+}
+
+std::string printf_i(int64_t value)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%" PRId64, value);
+	return buf;
+}
+
+}
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_unsigned()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), format_u(0));
+	CPPUNIT_ASSERT_EQUAL(std::string("7"), format_u(7));
+	CPPUNIT_ASSERT_EQUAL(std::string("18446744073709551615"), format_u(UINT64_MAX));
+
+	uint64_t power(1);
+	for (size_t i(0); i < 20; ++i) {
+		CPPUNIT_ASSERT_EQUAL(printf_u(power - 1), format_u(power - 1));
+		CPPUNIT_ASSERT_EQUAL(printf_u(power), format_u(power));
+		CPPUNIT_ASSERT_EQUAL(printf_u(power + 1), format_u(power + 1));
+		power *= 10;
+	}
+}
+
+void test::test_signed()
+{
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), format_i(0));
+	CPPUNIT_ASSERT_EQUAL(std::string("-1"), format_i(-1));
+	CPPUNIT_ASSERT_EQUAL(std::string("-10"), format_i(-10));
+	CPPUNIT_ASSERT_EQUAL(std::string("9223372036854775807"), format_i(INT64_MAX));
+	CPPUNIT_ASSERT_EQUAL(std::string("-9223372036854775808"), format_i(INT64_MIN));
+}
+
+void test::test_random()
+{
+	uint64_t state(0x2545f4914f6cdd1dULL);
+	for (size_t i(0); i < 10000; ++i) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		auto value(state >> (i % 64));
+		CPPUNIT_ASSERT_EQUAL(printf_u(value), format_u(value));
+		CPPUNIT_ASSERT_EQUAL(printf_i(int64_t(value)), format_i(int64_t(value)));
+	}
+}
+
+}}
@@ -19,6 +19,7 @@ private:
 	void test_number();
 	void test_number_conversions();
 	void test_string();
+	void test_string_reference();
 
 	CPPUNIT_TEST_SUITE(test);
 	CPPUNIT_TEST(test_null);
@@ -27,6 +28,7 @@ private:
 	CPPUNIT_TEST(test_number);
 	CPPUNIT_TEST(test_number_conversions);
 	CPPUNIT_TEST(test_string);
+	CPPUNIT_TEST(test_string_reference);
 	CPPUNIT_TEST_SUITE_END();
 };
 
@@ -83,11 +85,11 @@ void test::test_number()
 	ss.str("");
 
 	ss << Json::Number(0.0);
-	CPPUNIT_ASSERT_EQUAL(std::string("0.000000"), ss.str());
+	CPPUNIT_ASSERT_EQUAL(std::string("0.0"), ss.str());
 	ss.str("");
 
 	ss << Json::Number(0.00005);
-	CPPUNIT_ASSERT_EQUAL(std::string("0.000050"), ss.str());
+	CPPUNIT_ASSERT_EQUAL(std::string("0.00005"), ss.str());
 	ss.str("");
 
 	Json::Number n(5);
@@ -217,4 +219,28 @@ void test::test_string()
 	CPPUNIT_ASSERT_EQUAL(s, s1);
 }
 
+void test::test_string_reference()
+{
+	const char data[] = "Hello\"World";
+	auto s(Json::String::reference(data, 5));
+	CPPUNIT_ASSERT(s.is_reference());
+	CPPUNIT_ASSERT(!Json::String("Hello").is_reference());
+	CPPUNIT_ASSERT_EQUAL(static_cast<const char *>(data), s.data());
+	CPPUNIT_ASSERT_EQUAL(size_t(5), s.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("Hello"), s.value());
+	CPPUNIT_ASSERT_EQUAL(Json::String("Hello"), s);
+
+	Json::String s1(s);
+	CPPUNIT_ASSERT(s1.is_reference());
+	CPPUNIT_ASSERT_EQUAL(s.data(), s1.data());
+
+	s1 = Json::String("foo");
+	CPPUNIT_ASSERT(!s1.is_reference());
+	CPPUNIT_ASSERT_EQUAL(std::string("foo"), s1.value());
+
+	std::stringstream ss;
+	ss << Json::String::reference(data + 5, 6);
+	CPPUNIT_ASSERT_EQUAL(std::string("\"\\\"World\""), ss.str());
+}
+
 }}
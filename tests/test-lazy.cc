@@ -0,0 +1,246 @@
+#include <cstring>
+
+#include <jsoncc-cppunit.h>
+#include "error-assert.h"
+#include "error-io.h"
+
+namespace unittests {
+namespace lazy {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_empty_document();
+	void test_scalars();
+	void test_object();
+	void test_array();
+	void test_escaped_key();
+	void test_invalid_key();
+	void test_materialize();
+	void test_deferred_errors();
+	void test_structural_errors();
+	void test_max_nesting();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_empty_document);
+	CPPUNIT_TEST(test_scalars);
+	CPPUNIT_TEST(test_object);
+	CPPUNIT_TEST(test_array);
+	CPPUNIT_TEST(test_escaped_key);
+	CPPUNIT_TEST(test_invalid_key);
+	CPPUNIT_TEST(test_materialize);
+	CPPUNIT_TEST(test_deferred_errors);
+	CPPUNIT_TEST(test_structural_errors);
+	CPPUNIT_TEST(test_max_nesting);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_empty_document()
+{
+	char data[] = "   ";
+	Json::LazyDocument doc(data, sizeof(data) - 1);
+	CPPUNIT_ASSERT(!doc.root());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_INVALID, doc.root().tag());
+	CPPUNIT_ASSERT_EQUAL(Json::Value(), doc.root().value());
+}
+
+void test::test_scalars()
+{
+	char data[] = "[true, false, null, -12, 1.5e1, \"a\\tb\"]";
+	Json::LazyDocument doc(data, sizeof(data) - 1);
+
+	auto array(doc.root().array());
+	CPPUNIT_ASSERT_EQUAL(size_t(6), array.size());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_TRUE, array.element(0).tag());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_FALSE, array.element(1).tag());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_NULL, array.element(2).tag());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(-12)), array.element(3).number());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(15.0), array.element(4).number());
+	CPPUNIT_ASSERT_EQUAL(Json::String("a\tb"), array.element(5).string());
+	CPPUNIT_ASSERT_EQUAL(Json::Value(true), array.element(0).value());
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Null()), array.element(2).value());
+}
+
+void test::test_object()
+{
+	char data[] = "{\"a\": {\"x\": [1, 2]}, \"b\": 2, \"c\": {}}";
+	Json::LazyDocument doc(data, sizeof(data) - 1);
+
+	auto root(doc.root());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_OBJECT, root.tag());
+	auto object(root.object());
+	CPPUNIT_ASSERT_EQUAL(size_t(3), object.size());
+
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(2)), object.member("b").number());
+	CPPUNIT_ASSERT_EQUAL(size_t(0), object.member("c").object().size());
+	CPPUNIT_ASSERT(!object.member("x"));
+
+	auto x(object.member("a").object().member("x"));
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_ARRAY, x.tag());
+	CPPUNIT_ASSERT_EQUAL(size_t(2), x.array().size());
+
+	std::vector<std::string> keys;
+	for (auto member: object) {
+		keys.push_back(member.key().value());
+	}
+	CPPUNIT_ASSERT_EQUAL(size_t(3), keys.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("a"), keys[0]);
+	CPPUNIT_ASSERT_EQUAL(std::string("b"), keys[1]);
+	CPPUNIT_ASSERT_EQUAL(std::string("c"), keys[2]);
+}
+
+void test::test_array()
+{
+	char data[] = "[[1, [2]], {\"a\": [3]}, 4, []]";
+	Json::LazyDocument doc(data, sizeof(data) - 1);
+
+	auto array(doc.root().array());
+	CPPUNIT_ASSERT_EQUAL(size_t(4), array.size());
+
+	std::vector<Json::Value::Tag> tags;
+	for (auto element: array) {
+		tags.push_back(element.tag());
+	}
+	CPPUNIT_ASSERT_EQUAL(size_t(4), tags.size());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_ARRAY, tags[0]);
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_OBJECT, tags[1]);
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_NUMBER, tags[2]);
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_ARRAY, tags[3]);
+
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(4)), array.element(2).number());
+	CPPUNIT_ASSERT_EQUAL(size_t(0), array.element(3).array().size());
+	CPPUNIT_ASSERT(array.element(3).array().begin() == array.element(3).array().end());
+
+	// trailing commas, as accepted by the Parser
+	char trailing[] = "[1, [2,], ]";
+	Json::LazyDocument trailing_doc(trailing, sizeof(trailing) - 1);
+	CPPUNIT_ASSERT_EQUAL(size_t(2), trailing_doc.root().array().size());
+	CPPUNIT_ASSERT_EQUAL(Json::Parser().parse(trailing, sizeof(trailing) - 1),
+		trailing_doc.root().value());
+}
+
+void test::test_escaped_key()
+{
+	char data[] = "{\"a\\\"b\": 1, \"\\u00e4\": 2}";
+	Json::LazyDocument doc(data, sizeof(data) - 1);
+
+	auto object(doc.root().object());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(1)), object.member("a\"b").number());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(2)), object.member("\xc3\xa4").number());
+	CPPUNIT_ASSERT_EQUAL(Json::String("a\"b"), (*object.begin()).key());
+}
+
+void test::test_invalid_key()
+{
+	const std::string docs[] = {
+		"{\"\x01\": 1}",
+		"{\"\xff\": 1}",
+		"{\"a\xc3\": 1}",
+	};
+
+	for (auto const& data: docs) {
+		Json::Error expected;
+		CPPUNIT_ASSERT_THROW_VAR(Json::Parser().parse(data.data(), data.size()),
+			Json::Error, expected);
+
+		Json::LazyDocument doc(data.data(), data.size());
+		auto object(doc.root().object());
+
+		Json::Error error;
+		CPPUNIT_ASSERT_THROW_VAR((*object.begin()).key(), Json::Error, error);
+		CPPUNIT_ASSERT_EQUAL(expected.type, error.type);
+		CPPUNIT_ASSERT_THROW_VAR(object.member(data.substr(2, data.size() - 7)),
+			Json::Error, error);
+		CPPUNIT_ASSERT_EQUAL(expected.type, error.type);
+	}
+}
+
+void test::test_materialize()
+{
+	char data[] = "{\"a\": [true, {\"b\": null}], \"c\": \"d\"}";
+	Json::LazyDocument doc(data, sizeof(data) - 1);
+
+	Json::Parser parser;
+	CPPUNIT_ASSERT_EQUAL(parser.parse(data, sizeof(data) - 1), doc.root().value());
+
+	Json::Array expected;
+	expected << true << (Json::Object() << Json::Member("b", Json::Null()));
+	CPPUNIT_ASSERT_EQUAL(Json::Value(expected), doc.root().object().member("a").value());
+}
+
+void test::test_deferred_errors()
+{
+	char data[] = "[1, 1.5e, \"\\q\", {\"a\": 01}]";
+	Json::LazyDocument doc(data, sizeof(data) - 1);
+
+	auto array(doc.root().array());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(1)), array.element(0).number());
+
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(array.element(1).number(), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::NUMBER_INVALID, error.type);
+
+	CPPUNIT_ASSERT_THROW_VAR(array.element(2).string(), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::ESCAPE_INVALID, error.type);
+
+	CPPUNIT_ASSERT_THROW_VAR(array.element(3).value(), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_TOKEN_OBJECT_VALUE, error.type);
+}
+
+void test::test_structural_errors()
+{
+	struct {
+		const char *data;
+		Json::Error::Type type;
+	} docs[] = {
+		{"true",              Json::Error::BAD_TOKEN_DOCUMENT},
+		{"xyz",               Json::Error::TOKEN_INVALID},
+		{"[][]",              Json::Error::BAD_TOKEN_DOCUMENT},
+		{"[",                 Json::Error::BAD_TOKEN_ARRAY_START},
+		{"[1 2]",             Json::Error::BAD_TOKEN_ARRAY_VALUE},
+		{"[1,,]",             Json::Error::BAD_TOKEN_ARRAY_NEXT},
+		{"[1, x]",            Json::Error::TOKEN_INVALID},
+		{"{1: 2}",            Json::Error::BAD_TOKEN_OBJECT_START},
+		{"{\"a\" 1}",         Json::Error::BAD_TOKEN_OBJECT_NAME},
+		{"{\"a\": }",         Json::Error::BAD_TOKEN_OBJECT_SEP},
+		{"{\"a\": 1 \"b\"}",  Json::Error::BAD_TOKEN_OBJECT_VALUE},
+		{"{\"a\": 1, }",      Json::Error::BAD_TOKEN_OBJECT_NEXT},
+		{"[\"abc]",           Json::Error::STRING_QUOTE},
+		{"[nul]",             Json::Error::LITERAL_INVALID},
+	};
+
+	for (auto const& doc: docs) {
+		Json::Error error;
+		CPPUNIT_ASSERT_THROW_VAR(
+			Json::LazyDocument(doc.data, strlen(doc.data)), Json::Error, error);
+		CPPUNIT_ASSERT_EQUAL(doc.type, error.type);
+	}
+}
+
+void test::test_max_nesting()
+{
+	char data[256];
+	memset(data, '[', sizeof(data));
+
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(
+		Json::LazyDocument(data, sizeof(data)), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::PARSER_OVERFLOW, error.type);
+}
+
+}}
@@ -24,6 +24,10 @@ private:
 	void test_iterators();
 	void test_list_initialization();
 	void test_move();
+	void test_reserve();
+	void test_find_erase();
+	void test_map();
+	void test_unordered_map();
 
 	CPPUNIT_TEST_SUITE(test);
 	CPPUNIT_TEST(test_empty);
@@ -36,6 +40,10 @@ private:
 	CPPUNIT_TEST(test_iterators);
 	CPPUNIT_TEST(test_list_initialization);
 	CPPUNIT_TEST(test_move);
+	CPPUNIT_TEST(test_reserve);
+	CPPUNIT_TEST(test_find_erase);
+	CPPUNIT_TEST(test_map);
+	CPPUNIT_TEST(test_unordered_map);
 	CPPUNIT_TEST_SUITE_END();
 };
 
@@ -289,4 +297,79 @@ void test::test_move()
 	}
 }
 
+void test::test_reserve()
+{
+	Json::Object o;
+	o.reserve(100);
+	CPPUNIT_ASSERT_EQUAL(size_t(0), o.size());
+
+	o << Json::Member("a", Json::Number(1));
+	auto first(&*o.begin());
+	for (int i(1); i < 100; ++i) {
+		o << Json::Member(std::to_string(i), Json::Number(i));
+	}
+	// no reallocation
+	CPPUNIT_ASSERT_EQUAL(first, &*o.begin());
+	CPPUNIT_ASSERT_EQUAL(size_t(100), o.size());
+	CPPUNIT_ASSERT(o.capacity() >= 100);
+
+	o.reserve(1000);
+	CPPUNIT_ASSERT(o.capacity() >= 1000);
+	o.shrink_to_fit();
+	CPPUNIT_ASSERT_EQUAL(size_t(100), o.size());
+	CPPUNIT_ASSERT(o.capacity() < 1000);
+}
+
+void test::test_find_erase()
+{
+	Json::Object o{
+		{"a", Json::Number(1)},
+		{"b", Json::Object{{"c", Json::Null()}}},
+		{"a", Json::Number(2)},
+	};
+	Json::Object const& ref(o);
+	CPPUNIT_ASSERT(ref.find("x") == nullptr);
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Number(1)), *ref.find("a"));
+
+	*o.find("a") = Json::String("x");
+	o.find("b")->object() << Json::Member("d", Json::True());
+	CPPUNIT_ASSERT(o.erase("a"));
+	CPPUNIT_ASSERT(!o.erase("x"));
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Object{
+		{"b", Json::Object{{"c", Json::Null()}, {"d", Json::True()}}},
+		{"a", Json::Number(2)},
+	}), Json::Value(o));
+}
+
+void test::test_map()
+{
+	std::map<std::string, std::vector<int> > map{{"b", {1, 2}}, {"a", {}}};
+	Json::Value expected(Json::Object{
+		{"a", Json::Array()},
+		{"b", Json::Array{Json::Number(1), Json::Number(2)}},
+	});
+	CPPUNIT_ASSERT_EQUAL(expected, Json::Value(map));
+
+	std::stringstream ss;
+	ss << Json::noindent << Json::Value(map);
+	CPPUNIT_ASSERT_EQUAL(std::string("{\"a\": [], \"b\": [1, 2]}"), ss.str());
+
+	std::map<const char *, bool> keys{{"k", true}};
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Object{{"k", Json::True()}}), Json::Value(keys));
+}
+
+void test::test_unordered_map()
+{
+	std::unordered_map<std::string, std::string> map;
+	for (int i(0); i < 50; ++i) {
+		map[std::to_string(i)] = std::string(i, 'x');
+	}
+
+	Json::Value value(map);
+	CPPUNIT_ASSERT_EQUAL(size_t(50), value.object().size());
+	for (auto const& member: value.object()) {
+		CPPUNIT_ASSERT_EQUAL(map[member.key().value()], member.value().string().value());
+	}
+}
+
 }}}
@@ -40,6 +40,8 @@ private:
 	void test_error();
 	void test_parse_no_throw_fail();
 	void test_parse_no_throw_ok();
+	void test_parse_zerocopy();
+	void test_parse_insitu();
 
 	CPPUNIT_TEST_SUITE(test);
 	CPPUNIT_TEST(test_empty_document);
@@ -67,6 +69,8 @@ private:
 	CPPUNIT_TEST(test_error);
 	CPPUNIT_TEST(test_parse_no_throw_fail);
 	CPPUNIT_TEST(test_parse_no_throw_ok);
+	CPPUNIT_TEST(test_parse_zerocopy);
+	CPPUNIT_TEST(test_parse_insitu);
 	CPPUNIT_TEST_SUITE_END();
 };
 
@@ -508,4 +512,78 @@ void test::test_parse_no_throw_ok()
 	CPPUNIT_ASSERT_EQUAL(Json::Error::OK, error.type);
 }
 
+void test::test_parse_zerocopy()
+{
+	Json::Parser parser;
+
+	char data[] = "{\"key\": [\"plain\", \"esc\\taped\", \"\"], \"k\\u00e4\": \"\\u00e4\"}";
+	auto value(parser.parse_zerocopy(data, sizeof(data) - 1));
+	CPPUNIT_ASSERT_EQUAL(parser.parse(data, sizeof(data) - 1), value);
+
+	auto const& object(value.object());
+	auto key(object.begin()->key());
+	CPPUNIT_ASSERT(key.is_reference());
+	CPPUNIT_ASSERT_EQUAL(static_cast<const char *>(data + 2), key.data());
+
+	auto member(object.member("key"));
+	auto const& array(member.array());
+	auto plain(array.begin()->string());
+	CPPUNIT_ASSERT(plain.is_reference());
+	CPPUNIT_ASSERT_EQUAL(static_cast<const char *>(data + 10), plain.data());
+	CPPUNIT_ASSERT_EQUAL(std::string("plain"), plain.value());
+
+	auto escaped((array.begin() + 1)->string());
+	CPPUNIT_ASSERT(!escaped.is_reference());
+	CPPUNIT_ASSERT_EQUAL(std::string("esc\taped"), escaped.value());
+
+	auto empty((array.begin() + 2)->string());
+	CPPUNIT_ASSERT(empty.is_reference());
+	CPPUNIT_ASSERT_EQUAL(size_t(0), empty.size());
+
+	CPPUNIT_ASSERT(!(object.begin() + 1)->key().is_reference());
+
+	char bad[] = "[\"abc";
+	Json::Error error;
+	CPPUNIT_ASSERT_EQUAL(Json::Value(), parser.parse_zerocopy(bad, sizeof(bad) - 1, error));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::STRING_QUOTE, error.type);
+}
+
+void test::test_parse_insitu()
+{
+	Json::Parser parser;
+
+	char source[] = "{\"key\": [\"plain\", \"esc\\taped\", \"\\u20ac\\u00e4\\/\"], \"k\\u00e4\": 1}";
+	auto expected(parser.parse(source, sizeof(source) - 1));
+
+	char data[sizeof(source)];
+	memcpy(data, source, sizeof(source));
+	auto value(parser.parse_insitu(data, sizeof(data) - 1));
+	CPPUNIT_ASSERT_EQUAL(expected, value);
+
+	auto const& object(value.object());
+	auto member(object.member("key"));
+	auto const& array(member.array());
+	auto plain(array.begin()->string());
+	CPPUNIT_ASSERT(plain.is_reference());
+	CPPUNIT_ASSERT_EQUAL(static_cast<const char *>(data + 10), plain.data());
+
+	auto escaped((array.begin() + 1)->string());
+	CPPUNIT_ASSERT(escaped.is_reference());
+	CPPUNIT_ASSERT_EQUAL(static_cast<const char *>(data + 19), escaped.data());
+	CPPUNIT_ASSERT_EQUAL(std::string("esc\taped"), escaped.value());
+
+	auto unicode((array.begin() + 2)->string());
+	CPPUNIT_ASSERT(unicode.is_reference());
+	CPPUNIT_ASSERT_EQUAL(std::string("\xe2\x82\xac\xc3\xa4/"), unicode.value());
+
+	auto key((object.begin() + 1)->key());
+	CPPUNIT_ASSERT(key.is_reference());
+	CPPUNIT_ASSERT_EQUAL(std::string("k\xc3\xa4"), key.value());
+
+	char bad[] = "[\"a\\qc\"]";
+	Json::Error error;
+	CPPUNIT_ASSERT_EQUAL(Json::Value(), parser.parse_insitu(bad, sizeof(bad) - 1, error));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::ESCAPE_INVALID, error.type);
+}
+
 }}
@@ -0,0 +1,337 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include <jsoncc-cppunit.h>
+#include "error-assert.h"
+#include "error-io.h"
+
+namespace unittests {
+namespace patch {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_diff_equal();
+	void test_diff_object();
+	void test_diff_array();
+	void test_diff_escape();
+	void test_diff_duplicate_keys();
+	void test_diff_roundtrip();
+	void test_apply();
+	void test_apply_move_copy();
+	void test_apply_errors();
+	void test_merge_patch();
+	void test_merge_patch_in_place();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_diff_equal);
+	CPPUNIT_TEST(test_diff_object);
+	CPPUNIT_TEST(test_diff_array);
+	CPPUNIT_TEST(test_diff_escape);
+	CPPUNIT_TEST(test_diff_duplicate_keys);
+	CPPUNIT_TEST(test_diff_roundtrip);
+	CPPUNIT_TEST(test_apply);
+	CPPUNIT_TEST(test_apply_move_copy);
+	CPPUNIT_TEST(test_apply_errors);
+	CPPUNIT_TEST(test_merge_patch);
+	CPPUNIT_TEST(test_merge_patch_in_place);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+namespace {
+
+Json::Value parse(std::string const& data)
+{
+	Json::Parser parser;
+	return parser.parse(data.data(), data.size());
+}
+
+void assert_roundtrip(Json::Value const& from, Json::Value const& to)
+{
+	auto doc(from);
+	Json::apply(doc, Json::diff(from, to));
+	CPPUNIT_ASSERT_EQUAL(to, doc);
+}
+
+Json::Error::Type apply_error(std::string const& doc, std::string const& patch)
+{
+	auto value(parse(doc));
+	Json::Error error;
+	Json::apply(value, parse(patch), error);
+	return error.type;
+}
+
+Json::Value merge(std::string const& target, std::string const& patch)
+{
+	auto res(parse("[" + target + "]").array()[0]);
+	Json::merge_patch(res, parse("[" + patch + "]").array()[0]);
+	return res;
+}
+
+}
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_diff_equal()
+{
+	auto doc(parse("{\"a\": [1, {\"b\": null}], \"c\": \"d\"}"));
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Array()), Json::diff(doc, doc));
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Array()), Json::diff(doc,
+		parse("{\"c\": \"d\", \"a\": [1, {\"b\": null}]}")));
+}
+
+void test::test_diff_object()
+{
+	auto from(parse("{\"a\": 1, \"b\": {\"c\": true, \"d\": [1]}, \"e\": null}"));
+	auto to(parse("{\"a\": 1, \"b\": {\"c\": false, \"d\": [1]}, \"f\": \"x\"}"));
+	CPPUNIT_ASSERT_EQUAL(parse(
+		"[{\"op\": \"replace\", \"path\": \"/b/c\", \"value\": false},"
+		" {\"op\": \"remove\", \"path\": \"/e\"},"
+		" {\"op\": \"add\", \"path\": \"/f\", \"value\": \"x\"}]"),
+		Json::diff(from, to));
+	assert_roundtrip(from, to);
+
+	// number types differ
+	CPPUNIT_ASSERT_EQUAL(parse("[{\"op\": \"replace\", \"path\": \"/a\", \"value\": 1.0}]"),
+		Json::diff(from, parse("{\"a\": 1.0, \"b\": {\"c\": true, \"d\": [1]}, \"e\": null}")));
+
+	// whole document
+	CPPUNIT_ASSERT_EQUAL(parse("[{\"op\": \"replace\", \"path\": \"\", \"value\": [1]}]"),
+		Json::diff(from, parse("[1]")));
+}
+
+void test::test_diff_array()
+{
+	Json::Array large;
+	for (int i(0); i < 1000; ++i) {
+		large << Json::Object{{"id", Json::Number(i)}};
+	}
+	Json::Value from(large);
+
+	auto inserted(large);
+	inserted.insert(500, Json::String("new"));
+	CPPUNIT_ASSERT_EQUAL(parse("[{\"op\": \"add\", \"path\": \"/500\", \"value\": \"new\"}]"),
+		Json::diff(from, Json::Value(inserted)));
+
+	auto removed(large);
+	removed.erase(10);
+	removed.erase(20);
+	CPPUNIT_ASSERT_EQUAL(parse(
+		"[{\"op\": \"remove\", \"path\": \"/10\"},"
+		" {\"op\": \"remove\", \"path\": \"/20\"}]"),
+		Json::diff(from, Json::Value(removed)));
+
+	auto changed(large);
+	changed[700].object() << Json::Member("x", Json::True());
+	CPPUNIT_ASSERT_EQUAL(parse("[{\"op\": \"add\", \"path\": \"/700/x\", \"value\": true}]"),
+		Json::diff(from, Json::Value(changed)));
+
+	// moved element
+	auto moved(large);
+	auto element(moved[0]);
+	moved.erase(0);
+	moved.insert(999, element);
+	CPPUNIT_ASSERT_EQUAL(size_t(2), Json::diff(from, Json::Value(moved)).array().size());
+	assert_roundtrip(from, Json::Value(moved));
+
+	// compact arrays
+	assert_roundtrip(Json::Value(std::vector<int>{1, 2, 3, 4}),
+		Json::Value(std::vector<int>{0, 1, 3, 4, 5}));
+	CPPUNIT_ASSERT_EQUAL(parse("[{\"op\": \"replace\", \"path\": \"/1\", \"value\": 7}]"),
+		Json::diff(Json::Value(std::vector<int>{1, 2, 3}), parse("[1, 7, 3]")));
+}
+
+void test::test_diff_escape()
+{
+	auto from(parse("{\"a/b\": {\"~c\": 1}}"));
+	auto to(parse("{\"a/b\": {\"~c\": 2}}"));
+	CPPUNIT_ASSERT_EQUAL(parse("[{\"op\": \"replace\", \"path\": \"/a~1b/~0c\", \"value\": 2}]"),
+		Json::diff(from, to));
+	assert_roundtrip(from, to);
+}
+
+void test::test_diff_duplicate_keys()
+{
+	auto from(parse("{\"a\": 1, \"a\": 2, \"b\": 3}"));
+	auto to(parse("{\"a\": 1, \"a\": 4, \"b\": 3}"));
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Array{Json::Object{
+		{"op", Json::String("replace")},
+		{"path", Json::String("")},
+		{"value", to}}}), Json::diff(from, to));
+	assert_roundtrip(from, to);
+	assert_roundtrip(from, parse("{\"b\": 3, \"a\": 1}"));
+	CPPUNIT_ASSERT_EQUAL(Json::Value(Json::Array()),
+		Json::diff(from, parse("{\"b\": 3, \"a\": 2, \"a\": 1}")));
+}
+
+void test::test_diff_roundtrip()
+{
+	char const* docs[] = {
+		"[]",
+		"{}",
+		"[1, 2, 3]",
+		"[3, 2, 1]",
+		"[[1, 2], [3, 4], {\"a\": [5]}]",
+		"[[1, 2, 5], {\"a\": [6, 5]}, [3, 4]]",
+		"{\"a\": {\"b\": {\"c\": [1, {\"d\": null}]}}}",
+		"{\"a\": {\"b\": {\"c\": [{\"d\": false}, 1]}}, \"e\": []}",
+		"{\"x\": \"y\", \"a\": []}",
+	};
+
+	for (auto from: docs) {
+		for (auto to: docs) {
+			assert_roundtrip(parse(from), parse(to));
+		}
+	}
+}
+
+void test::test_apply()
+{
+	// rfc6902 appendix A
+	auto doc(parse("{\"foo\": [\"bar\", \"baz\"], \"qux\": {\"baz\": 1}}"));
+	Json::apply(doc, parse(
+		"[{\"op\": \"add\", \"path\": \"/foo/1\", \"value\": \"qux\"},"
+		" {\"op\": \"add\", \"path\": \"/foo/-\", \"value\": \"end\"},"
+		" {\"op\": \"remove\", \"path\": \"/foo/0\"},"
+		" {\"op\": \"add\", \"path\": \"/qux/baz\", \"value\": 2},"
+		" {\"op\": \"add\", \"path\": \"/qux/new\", \"value\": 3},"
+		" {\"op\": \"test\", \"path\": \"/foo\", \"value\": [\"qux\", \"baz\", \"end\"]},"
+		" {\"op\": \"test\", \"path\": \"/qux/baz\", \"value\": 2}]"));
+	CPPUNIT_ASSERT_EQUAL(parse(
+		"{\"foo\": [\"qux\", \"baz\", \"end\"], \"qux\": {\"baz\": 2, \"new\": 3}}"), doc);
+
+	Json::apply(doc, parse("[{\"op\": \"replace\", \"path\": \"\", \"value\": {\"a\": [1]}}]"));
+	CPPUNIT_ASSERT_EQUAL(parse("{\"a\": [1]}"), doc);
+}
+
+void test::test_apply_move_copy()
+{
+	auto doc(parse("{\"a\": {\"b\": [1, 2, 3]}, \"c\": {}}"));
+	Json::apply(doc, parse(
+		"[{\"op\": \"move\", \"from\": \"/a/b/0\", \"path\": \"/a/b/2\"},"
+		" {\"op\": \"copy\", \"from\": \"/a/b\", \"path\": \"/c/d\"},"
+		" {\"op\": \"move\", \"from\": \"/a\", \"path\": \"/e\"},"
+		" {\"op\": \"move\", \"from\": \"/e\", \"path\": \"/e\"}]"));
+	CPPUNIT_ASSERT_EQUAL(parse("{\"c\": {\"d\": [2, 3, 1]}, \"e\": {\"b\": [2, 3, 1]}}"), doc);
+}
+
+void test::test_apply_errors()
+{
+	std::string doc("{\"a\": [1, 2], \"b\": {\"c\": null}}");
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH, apply_error(doc, "{}"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH, apply_error(doc, "[[]]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH, apply_error(doc, "[{\"path\": \"/a\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH,
+		apply_error(doc, "[{\"op\": \"frob\", \"path\": \"/a\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH,
+		apply_error(doc, "[{\"op\": \"add\", \"path\": \"/x\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH,
+		apply_error(doc, "[{\"op\": \"remove\", \"path\": \"a\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH,
+		apply_error(doc, "[{\"op\": \"remove\", \"path\": \"/a~2\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH,
+		apply_error(doc, "[{\"op\": \"move\", \"from\": \"/b\", \"path\": \"/b/c\"}]"));
+
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"remove\", \"path\": \"/x\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"remove\", \"path\": \"\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"remove\", \"path\": \"/a/2\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"remove\", \"path\": \"/a/-\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"remove\", \"path\": \"/a/01\"}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"add\", \"path\": \"/a/3\", \"value\": 1}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"add\", \"path\": \"/b/c/d\", \"value\": 1}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"replace\", \"path\": \"/x\", \"value\": 1}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_PATCH_PATH,
+		apply_error(doc, "[{\"op\": \"copy\", \"from\": \"/x\", \"path\": \"/y\"}]"));
+
+	CPPUNIT_ASSERT_EQUAL(Json::Error::PATCH_TEST_FAILED,
+		apply_error(doc, "[{\"op\": \"test\", \"path\": \"/a/0\", \"value\": 1.0}]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::OK,
+		apply_error(doc, "[{\"op\": \"test\", \"path\": \"/a/0\", \"value\": 1}]"));
+
+	auto value(parse(doc));
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(Json::apply(value, parse("[{\"op\": \"test\", \"path\": \"/b\", \"value\": {}}]")),
+		Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::PATCH_TEST_FAILED, error.type);
+}
+
+void test::test_merge_patch()
+{
+	// rfc7396 appendix A
+	char const* cases[][3] = {
+		{"{\"a\":\"b\"}", "{\"a\":\"c\"}", "{\"a\":\"c\"}"},
+		{"{\"a\":\"b\"}", "{\"b\":\"c\"}", "{\"a\":\"b\",\"b\":\"c\"}"},
+		{"{\"a\":\"b\"}", "{\"a\":null}", "{}"},
+		{"{\"a\":\"b\",\"b\":\"c\"}", "{\"a\":null}", "{\"b\":\"c\"}"},
+		{"{\"a\":[\"b\"]}", "{\"a\":\"c\"}", "{\"a\":\"c\"}"},
+		{"{\"a\":\"c\"}", "{\"a\":[\"b\"]}", "{\"a\":[\"b\"]}"},
+		{"{\"a\":{\"b\":\"c\"}}", "{\"a\":{\"b\":\"d\",\"c\":null}}", "{\"a\":{\"b\":\"d\"}}"},
+		{"{\"a\":[{\"b\":\"c\"}]}", "{\"a\":[1]}", "{\"a\":[1]}"},
+		{"[\"a\",\"b\"]", "[\"c\",\"d\"]", "[\"c\",\"d\"]"},
+		{"{\"a\":\"b\"}", "[\"c\"]", "[\"c\"]"},
+		{"{\"a\":\"foo\"}", "null", "null"},
+		{"{\"a\":\"foo\"}", "\"bar\"", "\"bar\""},
+		{"{\"e\":null}", "{\"a\":1}", "{\"e\":null,\"a\":1}"},
+		{"[1,2]", "{\"a\":\"b\",\"c\":null}", "{\"a\":\"b\"}"},
+		{"{}", "{\"a\":{\"bb\":{\"ccc\":null}}}", "{\"a\":{\"bb\":{}}}"},
+	};
+
+	for (auto const& c: cases) {
+		auto expected(parse(std::string("[") + c[2] + "]").array()[0]);
+		CPPUNIT_ASSERT_EQUAL(expected, merge(c[0], c[1]));
+	}
+
+	// all members with a removed key
+	CPPUNIT_ASSERT_EQUAL(parse("{\"b\": 2}"),
+		merge("{\"a\": 1, \"b\": 2, \"a\": 3}", "{\"a\": null}"));
+}
+
+void test::test_merge_patch_in_place()
+{
+	auto target(parse("{\"keep\": {\"x\": [1, 2]}, \"change\": {\"y\": 1}}"));
+	auto patch(parse("{\"change\": {\"z\": \"new\"}, \"add\": [true]}"));
+
+	auto keep(&target.object().find("keep")->object());
+	auto change(&target.object().find("change")->object());
+	auto z(&patch.object().find("change")->object().find("z")->string());
+	auto add(&patch.object().find("add")->array());
+
+	Json::merge_patch(target, std::move(patch));
+	CPPUNIT_ASSERT_EQUAL(parse(
+		"{\"keep\": {\"x\": [1, 2]}, \"change\": {\"y\": 1, \"z\": \"new\"}, \"add\": [true]}"),
+		target);
+
+	// untouched and merged subtrees stay in place, patch values are moved
+	CPPUNIT_ASSERT_EQUAL(keep, &target.object().find("keep")->object());
+	CPPUNIT_ASSERT_EQUAL(change, &target.object().find("change")->object());
+	CPPUNIT_ASSERT_EQUAL(z, &target.object().find("change")->object().find("z")->string());
+	CPPUNIT_ASSERT_EQUAL(add, &target.object().find("add")->array());
+
+	// a const patch is copied
+	Json::Value const copy(parse("{\"keep\": null}"));
+	Json::merge_patch(target, copy);
+	CPPUNIT_ASSERT(!target.object().find("keep"));
+	CPPUNIT_ASSERT_EQUAL(parse("{\"keep\": null}"), copy);
+}
+
+}}
@@ -0,0 +1,295 @@
+#include <cstring>
+#include <functional>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include <jsoncc-cppunit.h>
+#include "error-assert.h"
+#include "error-io.h"
+
+namespace unittests {
+namespace reader {
+
+struct Point {
+	int32_t x;
+	int32_t y;
+	std::string label;
+};
+
+}}
+
+namespace Json {
+
+template<> struct ValueReader<unittests::reader::Point> {
+	static void read(Reader & reader, unittests::reader::Point & res)
+	{
+		std::string key;
+		reader.begin_object();
+		while (reader.next_member(key)) {
+			if (key == "x") {
+				ValueReader<int32_t>::read(reader, res.x);
+			} else if (key == "y") {
+				ValueReader<int32_t>::read(reader, res.y);
+			} else if (key == "label") {
+				res.label = reader.string();
+			} else {
+				reader.skip();
+			}
+		}
+	}
+};
+
+}
+
+namespace unittests {
+namespace reader {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_scalars();
+	void test_integer_ranges();
+	void test_containers();
+	void test_struct();
+	void test_value();
+	void test_pull();
+	void test_type_errors();
+	void test_grammar_errors();
+	void test_nesting();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_scalars);
+	CPPUNIT_TEST(test_integer_ranges);
+	CPPUNIT_TEST(test_containers);
+	CPPUNIT_TEST(test_struct);
+	CPPUNIT_TEST(test_value);
+	CPPUNIT_TEST(test_pull);
+	CPPUNIT_TEST(test_type_errors);
+	CPPUNIT_TEST(test_grammar_errors);
+	CPPUNIT_TEST(test_nesting);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+namespace {
+
+template <typename T>
+T parse_into(std::string const& str)
+{
+	Json::Parser parser;
+	return parser.parse_into<T>(str.data(), str.size());
+}
+
+template <typename T>
+Json::Error::Type parse_error(std::string const& str)
+{
+	Json::Parser parser;
+	T res;
+	Json::Error error;
+	parser.parse_into(str.data(), str.size(), res, error);
+	return error.type;
+}
+
+}
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_scalars()
+{
+	auto bools(parse_into<std::vector<bool> >("[true, false]"));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), bools.size());
+	CPPUNIT_ASSERT(bools[0]);
+	CPPUNIT_ASSERT(!bools[1]);
+
+	auto doubles(parse_into<std::vector<double> >("[1.5, -2, 1e300, 0]"));
+	CPPUNIT_ASSERT_EQUAL(1.5, doubles[0]);
+	CPPUNIT_ASSERT_EQUAL(-2.0, doubles[1]);
+	CPPUNIT_ASSERT_EQUAL(1e300, doubles[2]);
+	CPPUNIT_ASSERT_EQUAL(0.0, doubles[3]);
+
+	auto floats(parse_into<std::vector<float> >("[0.25]"));
+	CPPUNIT_ASSERT_EQUAL(0.25f, floats[0]);
+
+	auto strings(parse_into<std::vector<std::string> >(
+		"[\"plain\", \"esc\\naped\", \"\\u00e4\", \"\"]"));
+	CPPUNIT_ASSERT_EQUAL(size_t(4), strings.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("plain"), strings[0]);
+	CPPUNIT_ASSERT_EQUAL(std::string("esc\naped"), strings[1]);
+	CPPUNIT_ASSERT_EQUAL(std::string("\xc3\xa4"), strings[2]);
+	CPPUNIT_ASSERT_EQUAL(std::string(""), strings[3]);
+}
+
+void test::test_integer_ranges()
+{
+	auto int64s(parse_into<std::vector<int64_t> >(
+		"[-9223372036854775808, 9223372036854775807, 0]"));
+	CPPUNIT_ASSERT_EQUAL(int64_t(INT64_MIN), int64s[0]);
+	CPPUNIT_ASSERT_EQUAL(int64_t(INT64_MAX), int64s[1]);
+
+	auto int8s(parse_into<std::vector<int8_t> >("[-128, 127]"));
+	CPPUNIT_ASSERT_EQUAL(int8_t(-128), int8s[0]);
+	CPPUNIT_ASSERT_EQUAL(int8_t(127), int8s[1]);
+
+	auto uint16s(parse_into<std::vector<uint16_t> >("[0, 65535]"));
+	CPPUNIT_ASSERT_EQUAL(uint16_t(65535), uint16s[1]);
+
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<std::vector<int8_t> >("[128]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<std::vector<int8_t> >("[-129]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<std::vector<uint8_t> >("[256]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<std::vector<uint32_t> >("[-1]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<std::vector<uint64_t> >("[-1]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<std::vector<int32_t> >("[1.5]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<std::vector<int32_t> >("[1e3]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<std::vector<float> >("[1e300]"));
+}
+
+void test::test_containers()
+{
+	auto list(parse_into<std::list<int> >("[3, 1, 2]"));
+	CPPUNIT_ASSERT(list == std::list<int>({3, 1, 2}));
+
+	auto set(parse_into<std::set<std::string> >("[\"b\", \"a\", \"b\"]"));
+	CPPUNIT_ASSERT(set == std::set<std::string>({"a", "b"}));
+
+	auto map(parse_into<std::map<std::string, std::vector<int> > >(
+		"{\"a\": [1], \"b\": [], \"a\": [2, 3]}"));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), map.size());
+	CPPUNIT_ASSERT(map["a"] == std::vector<int>({2, 3}));
+	CPPUNIT_ASSERT(map["b"].empty());
+
+	auto nested(parse_into<std::vector<std::vector<int> > >("[[], [1, 2], [3]]"));
+	CPPUNIT_ASSERT_EQUAL(size_t(3), nested.size());
+	CPPUNIT_ASSERT(nested[1] == std::vector<int>({1, 2}));
+
+	// previous contents are replaced
+	Json::Parser parser;
+	std::vector<int> res{7, 8, 9};
+	parser.parse_into(" [4] ", 5, res);
+	CPPUNIT_ASSERT(res == std::vector<int>({4}));
+}
+
+void test::test_struct()
+{
+	auto points(parse_into<std::vector<Point> >(
+		"[{\"x\": 1, \"y\": -2, \"label\": \"a\"},"
+		" {\"extra\": {\"skip\": [1, {\"me\": null}]}, \"y\": 4, \"x\": 3}]"));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), points.size());
+	CPPUNIT_ASSERT_EQUAL(int32_t(1), points[0].x);
+	CPPUNIT_ASSERT_EQUAL(int32_t(-2), points[0].y);
+	CPPUNIT_ASSERT_EQUAL(std::string("a"), points[0].label);
+	CPPUNIT_ASSERT_EQUAL(int32_t(3), points[1].x);
+	CPPUNIT_ASSERT_EQUAL(int32_t(4), points[1].y);
+	CPPUNIT_ASSERT_EQUAL(std::string(""), points[1].label);
+}
+
+void test::test_value()
+{
+	std::string data("{\"a\": [1, 2.5, \"s\\t\", null, true, false], \"o\": {\"k\": {}}}");
+	Json::Parser parser;
+	auto expected(parser.parse(data.data(), data.size()));
+	CPPUNIT_ASSERT_EQUAL(expected, parse_into<Json::Value>(data));
+
+	auto members(parse_into<std::map<std::string, Json::Value> >(data));
+	CPPUNIT_ASSERT_EQUAL(expected.object().member("o"), members["o"]);
+}
+
+void test::test_pull()
+{
+	std::string data("[null, 1, {\"k\": \"v\"}]");
+	Json::Reader reader(data.data(), data.size());
+
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_ARRAY, reader.peek());
+	reader.begin_array();
+	CPPUNIT_ASSERT(reader.next_element());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_NULL, reader.peek());
+	reader.null();
+	CPPUNIT_ASSERT(reader.next_element());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_NUMBER, reader.peek());
+	CPPUNIT_ASSERT_EQUAL(1.0L, reader.real());
+	CPPUNIT_ASSERT(reader.next_element());
+	reader.begin_object();
+	std::string key;
+	CPPUNIT_ASSERT(reader.next_member(key));
+	CPPUNIT_ASSERT_EQUAL(std::string("k"), key);
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_STRING, reader.peek());
+	CPPUNIT_ASSERT_EQUAL(std::string("v"), reader.string());
+	CPPUNIT_ASSERT(!reader.next_member(key));
+	CPPUNIT_ASSERT(!reader.next_element());
+	reader.end();
+}
+
+void test::test_type_errors()
+{
+	typedef std::vector<int> Ints;
+	typedef std::map<std::string, int> Map;
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<Ints>("{}"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<Ints>("[\"1\"]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<Ints>("[null]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<Ints>("[[1]]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE,
+		parse_error<std::vector<bool> >("[0]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE,
+		parse_error<std::vector<std::string> >("[true]"));
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_READER_TYPE, parse_error<Map>("[]"));
+}
+
+void test::test_grammar_errors()
+{
+	typedef std::vector<int> Ints;
+	typedef std::map<std::string, int> Map;
+
+	// same errors as Parser::parse()
+	const char *docs[] = {
+		"", "1", "[] []", "[1 2]", "[,1]", "[1,,]", "[1",
+		"{1: 2}", "{\"a\" 1}", "{\"a\": }", "{\"a\": 1 \"b\"}", "{\"a\": 1, }",
+	};
+	for (auto doc: docs) {
+		Json::Parser parser;
+		Json::Error expected;
+		parser.parse(doc, strlen(doc), expected);
+		if (expected.type == Json::Error::OK) {
+			// the empty document, a reader expects a value
+			CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_TOKEN_DOCUMENT, parse_error<Ints>(doc));
+			continue;
+		}
+
+		auto actual(doc[0] == '{' ? parse_error<Map>(doc) : parse_error<Ints>(doc));
+		CPPUNIT_ASSERT_EQUAL(expected.type, actual);
+	}
+
+	CPPUNIT_ASSERT_EQUAL(Json::Error::UTF8_INVALID, parse_error<Ints>("[\"\xff\"]"));
+	CPPUNIT_ASSERT(parse_into<Ints>("[1, 2,]") == Ints({1, 2}));
+
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(parse_into<Ints>("[1] x"), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::TOKEN_INVALID, error.type);
+}
+
+void test::test_nesting()
+{
+	Json::Parser parser;
+	std::string deep(255, '[');
+	deep += std::string(255, ']');
+	CPPUNIT_ASSERT_EQUAL(parser.parse(deep.data(), deep.size()), parse_into<Json::Value>(deep));
+
+	deep = "[" + deep + "]";
+	CPPUNIT_ASSERT_EQUAL(Json::Error::PARSER_OVERFLOW, parse_error<Json::Value>(deep));
+
+	Json::Error error;
+	parser.parse(deep.data(), deep.size(), error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::PARSER_OVERFLOW, error.type);
+}
+
+}}
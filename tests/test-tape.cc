@@ -0,0 +1,155 @@
+#include <cstring>
+
+#include <jsoncc-cppunit.h>
+#include "error-assert.h"
+#include "error-io.h"
+
+namespace unittests {
+namespace tape {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_empty();
+	void test_scalars();
+	void test_object();
+	void test_nested();
+	void test_string_data();
+	void test_to_value();
+	void test_error();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_empty);
+	CPPUNIT_TEST(test_scalars);
+	CPPUNIT_TEST(test_object);
+	CPPUNIT_TEST(test_nested);
+	CPPUNIT_TEST(test_string_data);
+	CPPUNIT_TEST(test_to_value);
+	CPPUNIT_TEST(test_error);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_empty()
+{
+	Json::Tape tape;
+	CPPUNIT_ASSERT(!tape.root());
+
+	char data[] = "  ";
+	Json::Tape tape2(data, sizeof(data) - 1);
+	CPPUNIT_ASSERT(!tape2.root());
+	CPPUNIT_ASSERT_EQUAL(Json::Value(), tape2.root().value());
+
+	char data3[] = "[]";
+	Json::Tape tape3(data3, sizeof(data3) - 1);
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_ARRAY, tape3.root().tag());
+	CPPUNIT_ASSERT_EQUAL(size_t(0), tape3.root().array().size());
+	CPPUNIT_ASSERT(tape3.root().array().begin() == tape3.root().array().end());
+}
+
+void test::test_scalars()
+{
+	char data[] = "[true, false, null, -12, 0.5, \"a\\tb\"]";
+	Json::Tape tape(data, sizeof(data) - 1);
+
+	auto array(tape.root().array());
+	CPPUNIT_ASSERT_EQUAL(size_t(6), array.size());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_TRUE, array.element(0).tag());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_FALSE, array.element(1).tag());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_NULL, array.element(2).tag());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(-12)), array.element(3).number());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(0.5), array.element(4).number());
+	CPPUNIT_ASSERT_EQUAL(Json::String("a\tb"), array.element(5).string());
+}
+
+void test::test_object()
+{
+	char data[] = "{\"a\": 1, \"b\": [2, 3], \"c\": {\"d\": null}}";
+	Json::Tape tape(data, sizeof(data) - 1);
+
+	auto object(tape.root().object());
+	CPPUNIT_ASSERT_EQUAL(size_t(3), object.size());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(1)), object.member("a").number());
+	CPPUNIT_ASSERT_EQUAL(size_t(2), object.member("b").array().size());
+	CPPUNIT_ASSERT_EQUAL(Json::Value::TAG_NULL,
+		object.member("c").object().member("d").tag());
+	CPPUNIT_ASSERT(!object.member("d"));
+
+	std::vector<std::string> keys;
+	for (auto member: object) {
+		keys.push_back(member.key().value());
+	}
+	CPPUNIT_ASSERT_EQUAL(size_t(3), keys.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("a"), keys[0]);
+	CPPUNIT_ASSERT_EQUAL(std::string("b"), keys[1]);
+	CPPUNIT_ASSERT_EQUAL(std::string("c"), keys[2]);
+}
+
+void test::test_nested()
+{
+	char data[] = "[[1, [2.5, {}]], {\"a\": [[]]}, \"x\", 4]";
+	Json::Tape tape(data, sizeof(data) - 1);
+
+	auto array(tape.root().array());
+	CPPUNIT_ASSERT_EQUAL(size_t(4), array.size());
+
+	size_t count(0);
+	for (auto element: array) {
+		(void)element;
+		++count;
+	}
+	CPPUNIT_ASSERT_EQUAL(size_t(4), count);
+
+	CPPUNIT_ASSERT_EQUAL(Json::String("x"), array.element(2).string());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(int64_t(4)), array.element(3).number());
+	CPPUNIT_ASSERT_EQUAL(Json::Number(2.5),
+		array.element(0).array().element(1).array().element(0).number());
+	CPPUNIT_ASSERT_EQUAL(size_t(1),
+		array.element(1).object().member("a").array().size());
+}
+
+void test::test_string_data()
+{
+	char data[] = "[\"\", \"hello\"]";
+	Json::Tape tape(data, sizeof(data) - 1);
+
+	auto array(tape.root().array());
+	CPPUNIT_ASSERT_EQUAL(size_t(0), array.element(0).string_size());
+	CPPUNIT_ASSERT_EQUAL(size_t(5), array.element(1).string_size());
+	CPPUNIT_ASSERT_EQUAL(std::string("hello"),
+		std::string(array.element(1).string_data(), array.element(1).string_size()));
+}
+
+void test::test_to_value()
+{
+	char data[] = "{\"a\": [true, {\"b\": null}], \"c\": \"d\", \"e\": 1.5, \"f\": -1}";
+	Json::Tape tape(data, sizeof(data) - 1);
+
+	Json::Parser parser;
+	CPPUNIT_ASSERT_EQUAL(parser.parse(data, sizeof(data) - 1), tape.root().value());
+}
+
+void test::test_error()
+{
+	char data[] = "{\"a\": [}";
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(
+		Json::Tape(data, sizeof(data) - 1), Json::Error, error);
+	CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_TOKEN_ARRAY_START, error.type);
+}
+
+}}
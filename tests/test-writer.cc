@@ -0,0 +1,400 @@
+#include <algorithm>
+#include <functional>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <jsoncc.h>
+#include "error-assert.h"
+#include "error-io.h"
+#include "serializer.h"
+
+namespace unittests {
+namespace writer {
+
+class test : public CppUnit::TestCase {
+public:
+	test();
+	void setUp();
+	void tearDown();
+
+private:
+	void test_scalars();
+	void test_string_escapes();
+	void test_escape_scan();
+	void test_containers();
+	void test_sink();
+	void test_clear();
+	void test_stream();
+	void test_stream_sink();
+	void test_stream_bad_calls();
+	void test_indentation();
+	void test_serialized_size();
+	void test_container_writers();
+
+	CPPUNIT_TEST_SUITE(test);
+	CPPUNIT_TEST(test_scalars);
+	CPPUNIT_TEST(test_string_escapes);
+	CPPUNIT_TEST(test_escape_scan);
+	CPPUNIT_TEST(test_containers);
+	CPPUNIT_TEST(test_sink);
+	CPPUNIT_TEST(test_clear);
+	CPPUNIT_TEST(test_stream);
+	CPPUNIT_TEST(test_stream_sink);
+	CPPUNIT_TEST(test_stream_bad_calls);
+	CPPUNIT_TEST(test_indentation);
+	CPPUNIT_TEST(test_serialized_size);
+	CPPUNIT_TEST(test_container_writers);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(test);
+
+namespace {
+
+std::string stream(Json::Value const& value, bool indent)
+{
+	std::stringstream ss;
+	if (!indent) {
+		ss << Json::noindent;
+	}
+	ss << value;
+	return ss.str();
+}
+
+void assert_same(Json::Value const& value)
+{
+	Json::Writer indent;
+	indent.value(value);
+	CPPUNIT_ASSERT_EQUAL(stream(value, true), indent.str());
+
+	Json::Writer noindent(Json::Writer::STYLE_NOINDENT);
+	noindent.value(value);
+	CPPUNIT_ASSERT_EQUAL(stream(value, false), noindent.str());
+}
+
+class StringSink : public Json::Sink {
+public:
+	StringSink()
+	:
+		writes(0),
+		data()
+	{ }
+
+	void write(char const* buf, size_t size)
+	{
+		++writes;
+		data.append(buf, size);
+	}
+
+	size_t writes;
+	std::string data;
+};
+
+}
+
+test::test()
+{ }
+
+void test::setUp()
+{ }
+
+void test::tearDown()
+{ }
+
+void test::test_scalars()
+{
+	assert_same(Json::Null());
+	assert_same(Json::True());
+	assert_same(Json::False());
+	assert_same(Json::Number(0));
+	assert_same(Json::Number(-42));
+	assert_same(Json::Number(int64_t(INT64_MIN)));
+	assert_same(Json::Number(uint64_t(UINT64_MAX)));
+	assert_same(Json::Number(0.5));
+	assert_same(Json::Number(-1234.5678));
+	assert_same(Json::Number(1e300));
+	assert_same(Json::String(""));
+	assert_same(Json::String("foo"));
+}
+
+void test::test_string_escapes()
+{
+	std::string all;
+	for (int c(1); c < 0x80; ++c) {
+		all.push_back(c);
+	}
+	all += "\xc3\xa4";
+	assert_same(Json::String(all));
+	assert_same(Json::String(std::string("a\0b", 3)));
+	assert_same(Json::String("\"quoted\\"));
+}
+
+void test::test_escape_scan()
+{
+	CPPUNIT_ASSERT_EQUAL(size_t(0), Json::escape_scan("", 0));
+
+	for (size_t size(1); size < 40; ++size) {
+		std::string clean(size, '\x7f');
+		clean[0] = ' ';
+		clean[size - 1] = '\xff';
+		CPPUNIT_ASSERT_EQUAL(size, Json::escape_scan(clean.data(), size));
+
+		for (size_t pos(0); pos < size; ++pos) {
+			for (char c: {'\0', '\x1f', '"', '\\'}) {
+				auto str(clean);
+				str[pos] = c;
+				CPPUNIT_ASSERT_EQUAL(pos, Json::escape_scan(str.data(), size));
+			}
+		}
+	}
+
+	std::string long_run(1000, 'x');
+	long_run += "\n";
+	Json::Writer writer;
+	writer.value(Json::String(long_run));
+	CPPUNIT_ASSERT_EQUAL("\"" + std::string(1000, 'x') + "\\n\"", writer.str());
+}
+
+void test::test_containers()
+{
+	assert_same(Json::Array());
+	assert_same(Json::Object());
+	assert_same(Json::Array{Json::Number(1), Json::Null(), Json::String("x")});
+	assert_same(Json::Object{{"a", Json::Number(1)}, {"b", Json::True()}});
+
+	Json::Value nested(Json::Object{
+		{"empty", Json::Array()},
+		{"list", Json::Array{
+			Json::Object(),
+			Json::Object{{"k", Json::Array{Json::Number(2.5)}}},
+			Json::Array{Json::Array{}},
+		}},
+		{"obj", Json::Object{{"x\ny", Json::String("\t")}}},
+	});
+	assert_same(nested);
+
+	Json::Writer writer(Json::Writer::STYLE_NOINDENT);
+	writer.value(Json::Array{Json::Number(1)}).value(Json::Object());
+	CPPUNIT_ASSERT_EQUAL(std::string("[1]{}"), writer.str());
+}
+
+void test::test_sink()
+{
+	StringSink sink;
+	std::string big(100000, 'x');
+	{
+		Json::Writer writer(sink, Json::Writer::STYLE_NOINDENT);
+		writer.value(Json::Number(1));
+		CPPUNIT_ASSERT_EQUAL(size_t(0), sink.writes);
+		CPPUNIT_ASSERT_EQUAL(size_t(1), writer.size());
+
+		writer.flush();
+		CPPUNIT_ASSERT_EQUAL(size_t(1), sink.writes);
+		CPPUNIT_ASSERT_EQUAL(size_t(0), writer.size());
+
+		writer.value(Json::String(big));
+		CPPUNIT_ASSERT(sink.writes > 1);
+		writer.value(Json::Null());
+	}
+	CPPUNIT_ASSERT_EQUAL("1\"" + big + "\"null", sink.data);
+}
+
+void test::test_clear()
+{
+	Json::Writer writer;
+	writer.value(Json::True());
+	CPPUNIT_ASSERT_EQUAL(std::string("true"), std::string(writer.data(), writer.size()));
+	writer.clear();
+	CPPUNIT_ASSERT_EQUAL(size_t(0), writer.size());
+	writer.value(Json::False());
+	CPPUNIT_ASSERT_EQUAL(std::string("false"), writer.str());
+}
+
+void test::test_stream()
+{
+	Json::Value expected(Json::Object{
+		{"empty", Json::Object()},
+		{"list", Json::Array{
+			Json::Number(1),
+			Json::Array(),
+			Json::Object{{"k", Json::String("v")}},
+		}},
+		{"last", Json::Null()},
+	});
+
+	for (auto style: {Json::Writer::STYLE_INDENT, Json::Writer::STYLE_NOINDENT}) {
+		Json::Writer writer(style);
+		writer.begin_object();
+		CPPUNIT_ASSERT_EQUAL(size_t(1), writer.depth());
+		writer
+			.key("empty").begin_object().end_object()
+			.key("list").begin_array()
+				.value(Json::Number(1))
+				.begin_array().end_array()
+				.value(Json::Object{{"k", Json::String("v")}})
+			.end_array()
+			.key("last").value(Json::Null())
+		.end_object();
+		CPPUNIT_ASSERT_EQUAL(size_t(0), writer.depth());
+
+		Json::Writer tree(style);
+		tree.value(expected);
+		CPPUNIT_ASSERT_EQUAL(tree.str(), writer.str());
+	}
+}
+
+void test::test_stream_sink()
+{
+	StringSink sink;
+	size_t max_buffered(0);
+	{
+		Json::Writer writer(sink, Json::Writer::STYLE_NOINDENT);
+		writer.begin_array();
+		for (int i(0); i < 100000; ++i) {
+			writer.begin_object().key("i").value(Json::Number(i)).end_object();
+			max_buffered = std::max(max_buffered, writer.size());
+		}
+		writer.end_array();
+	}
+
+	CPPUNIT_ASSERT(max_buffered <= 1 << 16);
+	CPPUNIT_ASSERT(sink.writes > 1);
+
+	Json::Parser parser;
+	auto value(parser.parse(sink.data.data(), sink.data.size()));
+	CPPUNIT_ASSERT_EQUAL(size_t(100000), value.array().size());
+}
+
+void test::test_stream_bad_calls()
+{
+	auto bad_call([](std::function<void(Json::Writer &)> calls) {
+		Json::Writer writer;
+		Json::Error error;
+		CPPUNIT_ASSERT_THROW_VAR(calls(writer), Json::Error, error);
+		CPPUNIT_ASSERT_EQUAL(Json::Error::BAD_WRITER_CALL, error.type);
+	});
+
+	bad_call([](Json::Writer & w) { w.key("a"); });
+	bad_call([](Json::Writer & w) { w.end_object(); });
+	bad_call([](Json::Writer & w) { w.end_array(); });
+	bad_call([](Json::Writer & w) { w.begin_array().key("a"); });
+	bad_call([](Json::Writer & w) { w.begin_array().end_object(); });
+	bad_call([](Json::Writer & w) { w.begin_object().end_array(); });
+	bad_call([](Json::Writer & w) { w.begin_object().value(Json::Null()); });
+	bad_call([](Json::Writer & w) { w.begin_object().begin_array(); });
+	bad_call([](Json::Writer & w) { w.begin_object().key("a").key("b"); });
+	bad_call([](Json::Writer & w) { w.begin_object().key("a").end_object(); });
+
+	// a rejected call leaves the output unchanged
+	Json::Writer writer(Json::Writer::STYLE_NOINDENT);
+	writer.begin_object();
+	Json::Error error;
+	CPPUNIT_ASSERT_THROW_VAR(writer.end_array(), Json::Error, error);
+	writer.key("a").value(Json::True()).end_object();
+	CPPUNIT_ASSERT_EQUAL(std::string("{\"a\": true}"), writer.str());
+}
+
+void test::test_indentation()
+{
+	Json::Value value(Json::Object{
+		{"a", Json::Array{Json::Number(1), Json::Object{{"b", Json::Array()}}}},
+	});
+
+	Json::Writer spaces(Json::Writer::STYLE_INDENT, ' ', 2);
+	spaces.value(value);
+	CPPUNIT_ASSERT_EQUAL(std::string(
+		"{\n"
+		"  \"a\": [\n"
+		"    1,\n"
+		"    {\n"
+		"      \"b\": []\n"
+		"    }\n"
+		"  ]\n"
+		"}"), spaces.str());
+
+	Json::Writer flat(Json::Writer::STYLE_INDENT, ' ', 0);
+	flat.value(value);
+	CPPUNIT_ASSERT_EQUAL(std::string("{\n\"a\": [\n1,\n{\n\"b\": []\n}\n]\n}"), flat.str());
+
+	// deeper than the initial indentation string
+	Json::Value deep(Json::Number(0));
+	for (int i(0); i < 40; ++i) {
+		deep = Json::Array{deep};
+	}
+	Json::Writer writer(Json::Writer::STYLE_INDENT, ' ', 3);
+	writer.value(deep);
+	auto str(writer.str());
+	auto zero(str.find('0'));
+	CPPUNIT_ASSERT_EQUAL(std::string(120, ' '), str.substr(zero - 120, 120));
+	CPPUNIT_ASSERT_EQUAL('\n', str[zero - 121]);
+	CPPUNIT_ASSERT_EQUAL(std::string("\n]"), str.substr(str.size() - 2));
+}
+
+void test::test_serialized_size()
+{
+	Json::Value values[] = {
+		Json::Null(),
+		Json::Number(-12345),
+		Json::Number(0.1),
+		Json::String("esc\"aped\x01"),
+		Json::Array(),
+		Json::Object{
+			{"list", Json::Array{Json::Number(1), Json::Object(), Json::Array{Json::False()}}},
+			{"b", Json::Object{{"\xc3\xa4", Json::String(std::string(5000, 'x') + "\n")}}},
+			{"a", Json::Number(uint64_t(UINT64_MAX))},
+		},
+	};
+
+	const Json::Writer::Style styles[] = {
+		Json::Writer::STYLE_INDENT,
+		Json::Writer::STYLE_NOINDENT,
+		Json::Writer::STYLE_CANONICAL,
+	};
+
+	for (auto const& value: values) {
+		for (auto style: styles) {
+			Json::Writer writer(style, ' ', 3);
+			writer.value(value);
+			auto expected(writer.str());
+
+			auto size(Json::serialized_size(value, style, ' ', 3));
+			CPPUNIT_ASSERT_EQUAL(expected.size(), size);
+
+			std::string buf(size + 1, '#');
+			CPPUNIT_ASSERT_EQUAL(size, Json::serialize(value, &buf[0], style, ' ', 3));
+			CPPUNIT_ASSERT_EQUAL(expected + "#", buf);
+		}
+	}
+}
+
+void test::test_container_writers()
+{
+	typedef std::map<std::string, std::vector<double> > Map;
+	Map map{{"b", {0.5, -1.0}}, {"a", {}}};
+	std::list<std::string> list{"x", "y\n"};
+	std::set<uint8_t> set{3, 1};
+	std::vector<bool> bools{true, false};
+
+	Json::Writer writer(Json::Writer::STYLE_NOINDENT);
+	Json::ValueWriter<Map>::write(writer, map);
+	Json::ValueWriter<std::list<std::string> >::write(writer, list);
+	Json::ValueWriter<std::set<uint8_t> >::write(writer, set);
+	Json::ValueWriter<std::vector<bool> >::write(writer, bools);
+	CPPUNIT_ASSERT_EQUAL(std::string(
+		"{\"a\": [], \"b\": [0.5, -1.0]}"
+		"[\"x\", \"y\\n\"]"
+		"[1, 3]"
+		"[true, false]"), writer.str());
+
+	// same output as the Value of the container
+	std::vector<double> samples(1000);
+	for (size_t i(0); i < samples.size(); ++i) {
+		samples[i] = i * 0.1;
+	}
+	Json::Writer direct;
+	Json::ValueWriter<std::vector<double> >::write(direct, samples);
+	Json::Writer tree;
+	tree.value(Json::Value(samples));
+	CPPUNIT_ASSERT_EQUAL(tree.str(), direct.str());
+}
+
+}}